@@ -0,0 +1,35 @@
+#!/bin/bash
+# Compare the branching policies within subsets on one graph.
+# usage: ./branching_benchmark.sh graph_file [subset_size_limit [repetitions [threads]]]
+if [ $# -lt 1 ]
+then
+	printf "graph,limit,threads,policy,run,BB[sec],BB(iterations),Total[sec],weight\n"
+	exit 0
+fi
+
+graph_file=$1
+limit=${2:--1}
+repetitions=${3:-3}
+threads=${4:-1}
+
+if [ $limit -eq -1 ]; then
+    n=`grep 'p edge' $graph_file | sed 's/  */ /g' | cut -d ' ' -f3`
+    if [ $n -le 1500 ]; then
+        limit=25
+    else
+        limit=20
+    fi
+fi
+
+for policy in msb max-weight max-degree max-reduction
+do
+    for run in `seq 1 $repetitions`
+    do
+        result=`./otclique --branching $policy --threads $threads $graph_file $limit`
+        bb=`echo "$result" | grep '^Branch-and-bound phase' | cut -d ' ' -f4`
+        iterations=`echo "$result" | grep '^Branch-and-bound iterations' | cut -d ' ' -f4`
+        total=`echo "$result" | grep '^Total time' | cut -d ' ' -f4`
+        weight=`echo "$result" | grep '^Maximum weight' | cut -d ' ' -f4`
+        printf "%s,%s,%s,%s,%s,%s,%s,%s,%s\n" "${graph_file##*/}" $limit $threads $policy $run $bb $iterations $total $weight
+    done
+done
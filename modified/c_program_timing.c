@@ -1,5 +1,6 @@
 #define _POSIX_C_SOURCE 199309L
 
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <time.h>
 #include "c_program_timing.h"
@@ -8,7 +9,8 @@ struct timespec start_time;
 
 long time_limit_sec = 0;
 
-bool timed_out = false;
+// Set by whichever search thread notices the timeout first
+atomic_bool timed_out = false;
 
 // Based on https://gist.github.com/diabloneo/9619917
 struct timespec timespec_diff(struct timespec start,
@@ -36,7 +38,14 @@ void set_time_limit_sec(long time_limit)
 
 void check_for_timeout()
 {
-    timed_out = time_limit_sec && get_elapsed_timespec().tv_sec >= time_limit_sec;
+    if (time_limit_sec && get_elapsed_timespec().tv_sec >= time_limit_sec)
+        timed_out = true;
+}
+
+// Stop the search as if the time limit had expired
+void set_timeout_flag()
+{
+    timed_out = true;
 }
 
 bool is_timeout_flag_set()
@@ -10,4 +10,6 @@ void set_time_limit_sec(long time_limit);
 
 void check_for_timeout();
 
+void set_timeout_flag();
+
 bool is_timeout_flag_set();
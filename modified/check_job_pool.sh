@@ -0,0 +1,38 @@
+#!/bin/bash
+# Check that job_pool.sh finds the maximum weight the solver finds directly,
+# and that a lower bound at the maximum leaves it as the answer.
+# usage: ./check_job_pool.sh graph_file... [-- workers [subset_size_limit]]
+graph_files=()
+while [ $# -gt 0 ] && [ "$1" != "--" ]
+do
+	graph_files+=("$1")
+	shift
+done
+[ "$1" = "--" ] && shift
+if [ ${#graph_files[@]} -eq 0 ]
+then
+	echo "usage: $0 graph_file... [-- workers [subset_size_limit]]"
+	exit 1
+fi
+workers=${1:-2}
+limit=${2:--1}
+
+status=0
+for graph_file in "${graph_files[@]}"
+do
+    if [ $limit -eq -1 ]; then
+        direct=`./otclique $graph_file`
+    else
+        direct=`./otclique $graph_file $limit`
+    fi
+    weight=`echo "$direct" | grep '^Maximum weight' | cut -d ' ' -f4`
+    pooled=`./job_pool.sh $graph_file $workers $limit | grep '^Maximum weight' | cut -d ' ' -f4`
+    bounded=`./job_pool.sh $graph_file $workers $limit $weight | grep -c "^No clique is heavier than the lower bound $weight$"`
+    if [ "$pooled" = "$weight" ] && [ "$bounded" = 1 ]; then
+        echo "${graph_file##*/}: OK, weight $weight"
+    else
+        echo "${graph_file##*/}: FAILED, direct $weight, job_pool.sh $pooled, lower bound $weight reported $bounded times"
+        status=1
+    fi
+done
+exit $status
@@ -0,0 +1,144 @@
+#include <stddef.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#include "cpu_kernels.h"
+
+static void dp_sweep_scalar(long long *table,long long start,long long adjacency,long long weight)
+{
+    long long end = start << 1;
+    for(long long j = start; j < end; ++j)
+    {
+        long long unused = table[j-start];
+        long long used = table[adjacency & j] + weight;
+        table[j] = unused < used ? used : unused;
+    }
+}
+
+static long long count_nonzero_scalar(const long long *row,long long n)
+{
+    long long count=0;
+    for(long long j=0;j<n;j++)
+    {
+        count+=row[j] != 0;
+    }
+    return count;
+}
+
+#if defined(__x86_64__)
+/*
+   The entries j & adjacency lie below start, so every entry of the
+   sweep reads only entries of earlier sweeps and the lanes are independent.
+ */
+__attribute__((target("avx2")))
+static void dp_sweep_avx2(long long *table,long long start,long long adjacency,long long weight)
+{
+    if(start < 4)
+    {
+        dp_sweep_scalar(table,start,adjacency,weight);
+        return;
+    }
+    __m256i mask = _mm256_set1_epi64x(adjacency);
+    __m256i weights = _mm256_set1_epi64x(weight);
+    __m256i index = _mm256_add_epi64(_mm256_set1_epi64x(start),_mm256_set_epi64x(3,2,1,0));
+    __m256i step = _mm256_set1_epi64x(4);
+    for(long long j = 0; j < start; j += 4)
+    {
+        __m256i unused = _mm256_loadu_si256((const __m256i *)(table+j));
+        __m256i used = _mm256_add_epi64(_mm256_i64gather_epi64(table,_mm256_and_si256(index,mask),8),weights);
+        _mm256_storeu_si256((__m256i *)(table+start+j),
+                _mm256_blendv_epi8(unused,used,_mm256_cmpgt_epi64(used,unused)));
+        index = _mm256_add_epi64(index,step);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void dp_sweep_avx512(long long *table,long long start,long long adjacency,long long weight)
+{
+    if(start < 8)
+    {
+        dp_sweep_scalar(table,start,adjacency,weight);
+        return;
+    }
+    __m512i mask = _mm512_set1_epi64(adjacency);
+    __m512i weights = _mm512_set1_epi64(weight);
+    __m512i index = _mm512_add_epi64(_mm512_set1_epi64(start),_mm512_set_epi64(7,6,5,4,3,2,1,0));
+    __m512i step = _mm512_set1_epi64(8);
+    for(long long j = 0; j < start; j += 8)
+    {
+        __m512i unused = _mm512_loadu_si512(table+j);
+        __m512i used = _mm512_add_epi64(_mm512_i64gather_epi64(_mm512_and_si512(index,mask),table,8),weights);
+        _mm512_storeu_si512(table+start+j,_mm512_max_epi64(unused,used));
+        index = _mm512_add_epi64(index,step);
+    }
+}
+
+__attribute__((target("avx2")))
+static long long count_nonzero_avx2(const long long *row,long long n)
+{
+    __m256i zeros = _mm256_setzero_si256();
+    long long j=0;
+    for(;j+4<=n;j+=4)
+    {
+        __m256i words = _mm256_loadu_si256((const __m256i *)(row+j));
+        zeros = _mm256_sub_epi64(zeros,_mm256_cmpeq_epi64(words,_mm256_setzero_si256()));
+    }
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(zeros),_mm256_extracti128_si256(zeros,1));
+    long long count = j - _mm_cvtsi128_si64(half) - _mm_extract_epi64(half,1);
+    return count + count_nonzero_scalar(row+j,n-j);
+}
+#endif
+
+static void (*dp_sweep_kernel)(long long *,long long,long long,long long) = dp_sweep_scalar;
+static long long (*count_nonzero_kernel)(const long long *,long long) = count_nonzero_scalar;
+static const char *dp_sweep_name = "scalar";
+static const char *count_nonzero_name = "scalar";
+static long long lzcnt = 0;
+
+void select_cpu_kernels()
+{
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    lzcnt = __builtin_cpu_supports("lzcnt") != 0;
+    if(__builtin_cpu_supports("avx512f"))
+    {
+        dp_sweep_kernel = dp_sweep_avx512;
+        dp_sweep_name = "avx512";
+    }
+    else if(__builtin_cpu_supports("avx2"))
+    {
+        dp_sweep_kernel = dp_sweep_avx2;
+        dp_sweep_name = "avx2";
+    }
+    if(__builtin_cpu_supports("avx2"))
+    {
+        count_nonzero_kernel = count_nonzero_avx2;
+        count_nonzero_name = "avx2";
+    }
+#endif
+}
+
+void dp_sweep(long long *table,long long start,long long adjacency,long long weight)
+{
+    dp_sweep_kernel(table,start,adjacency,weight);
+}
+
+long long count_nonzero(const long long *row,long long n)
+{
+    return count_nonzero_kernel(row,n);
+}
+
+long long cpu_has_lzcnt()
+{
+    return lzcnt;
+}
+
+const char *dp_sweep_isa()
+{
+    return dp_sweep_name;
+}
+
+const char *count_nonzero_isa()
+{
+    return count_nonzero_name;
+}
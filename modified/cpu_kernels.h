@@ -0,0 +1,27 @@
+#ifndef cpu_kernels_h
+#define cpu_kernels_h
+
+/*
+   Kernels of the precomputation with variants for instruction set
+   extensions.  select_cpu_kernels() chooses the widest variant the
+   processor supports; until then the portable variants are used.
+ */
+void select_cpu_kernels();
+
+/*
+   table[j] = max(table[j-start], table[j & adjacency] + weight)
+   for start <= j < 2*start, where adjacency has no bit at or above start
+ */
+void dp_sweep(long long *table,long long start,long long adjacency,long long weight);
+
+/*
+   <return>
+    the number of nonzero entries of row[0..n-1]
+ */
+long long count_nonzero(const long long *row,long long n);
+
+long long cpu_has_lzcnt();
+const char *dp_sweep_isa();
+const char *count_nonzero_isa();
+
+#endif
@@ -0,0 +1,199 @@
+#include <stddef.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#include "intersection_kernels.h"
+
+static const char *selected_isa = "scalar";
+static long long prefetch_distance = 0;
+
+static long long intersect_and_bound_scalar(const long long *set,const long long *adjv,
+        long long size,long long *set2,const long long *tables,const long long *table_offset)
+{
+    long long upper=0;
+    for(long long j=0;j<size;j++)
+    {
+        set2[j] = set[j] & adjv[j];
+        upper += tables[table_offset[j]+set2[j]];
+    }
+    return upper;
+}
+
+/*
+   Two-pass pipeline for tables too large for the caches: the word
+   distance places ahead is intersected and its table slot is
+   prefetched, while the slot of the current word is added to the bound.
+ */
+long long intersect_and_bound_ahead(const long long *set,const long long *adjv,
+        long long size,long long *set2,const long long *tables,const long long *table_offset,
+        long long distance)
+{
+    if(distance <= 0)
+    {
+        return intersect_and_bound_scalar(set,adjv,size,set2,tables,table_offset);
+    }
+    long long upper=0;
+    long long ahead = size < distance ? size : distance;
+    for(long long j=0;j<ahead;j++)
+    {
+        set2[j] = set[j] & adjv[j];
+        __builtin_prefetch(&tables[table_offset[j]+set2[j]]);
+    }
+    for(long long j=0;j<size;j++)
+    {
+        long long k=j+distance;
+        if(k < size)
+        {
+            set2[k] = set[k] & adjv[k];
+            __builtin_prefetch(&tables[table_offset[k]+set2[k]]);
+        }
+        upper += tables[table_offset[j]+set2[j]];
+    }
+    return upper;
+}
+
+static long long intersect_and_bound_prefetch(const long long *set,const long long *adjv,
+        long long size,long long *set2,const long long *tables,const long long *table_offset)
+{
+    return intersect_and_bound_ahead(set,adjv,size,set2,tables,table_offset,prefetch_distance);
+}
+
+#if defined(__x86_64__)
+/*
+   The entries are gathered from the block of the tables: the lanes
+   hold table_offset[j] + set2[j].
+ */
+__attribute__((target("avx2")))
+static long long intersect_and_bound_avx2(const long long *set,const long long *adjv,
+        long long size,long long *set2,const long long *tables,const long long *table_offset)
+{
+    __m256i sum = _mm256_setzero_si256();
+    long long j=0;
+    for(;j+4<=size;j+=4)
+    {
+        __m256i words = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(set+j)),
+                _mm256_loadu_si256((const __m256i *)(adjv+j)));
+        _mm256_storeu_si256((__m256i *)(set2+j),words);
+        __m256i index = _mm256_add_epi64(_mm256_loadu_si256((const __m256i *)(table_offset+j)),words);
+        sum = _mm256_add_epi64(sum,_mm256_i64gather_epi64(tables,index,8));
+    }
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sum),_mm256_extracti128_si256(sum,1));
+    long long upper = _mm_cvtsi128_si64(half) + _mm_extract_epi64(half,1);
+    for(;j<size;j++)
+    {
+        set2[j] = set[j] & adjv[j];
+        upper += tables[table_offset[j]+set2[j]];
+    }
+    return upper;
+}
+
+__attribute__((target("avx512f")))
+static long long intersect_and_bound_avx512(const long long *set,const long long *adjv,
+        long long size,long long *set2,const long long *tables,const long long *table_offset)
+{
+    __m512i sum = _mm512_setzero_si512();
+    long long j=0;
+    for(;j+8<=size;j+=8)
+    {
+        __m512i words = _mm512_and_si512(_mm512_loadu_si512(set+j),_mm512_loadu_si512(adjv+j));
+        _mm512_storeu_si512(set2+j,words);
+        __m512i index = _mm512_add_epi64(_mm512_loadu_si512(table_offset+j),words);
+        sum = _mm512_add_epi64(sum,_mm512_i64gather_epi64(index,tables,8));
+    }
+    if(j<size)
+    {
+        __mmask8 tail = (__mmask8)((1u<<(size-j))-1);
+        __m512i words = _mm512_and_si512(_mm512_maskz_loadu_epi64(tail,set+j),
+                _mm512_maskz_loadu_epi64(tail,adjv+j));
+        _mm512_mask_storeu_epi64(set2+j,tail,words);
+        __m512i index = _mm512_add_epi64(_mm512_maskz_loadu_epi64(tail,table_offset+j),words);
+        sum = _mm512_add_epi64(sum,_mm512_mask_i64gather_epi64(_mm512_setzero_si512(),tail,index,tables,8));
+    }
+    return _mm512_reduce_add_epi64(sum);
+}
+#endif
+
+/*
+   choose the kernel: the prefetching pipeline if distance is positive,
+   otherwise the widest kernel the processor supports
+ */
+intersect_and_bound_kernel select_intersect_and_bound(long long distance)
+{
+    prefetch_distance = distance;
+    if(distance > 0)
+    {
+        selected_isa = "scalar with prefetch";
+        return intersect_and_bound_prefetch;
+    }
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f"))
+    {
+        selected_isa = "avx512";
+        return intersect_and_bound_avx512;
+    }
+    if(__builtin_cpu_supports("avx2"))
+    {
+        selected_isa = "avx2";
+        return intersect_and_bound_avx2;
+    }
+#endif
+    selected_isa = "scalar";
+    return intersect_and_bound_scalar;
+}
+
+intersect_and_bound_kernel select_fastest_intersect_and_bound(double (*time)(intersect_and_bound_kernel kernel),
+        long long rounds)
+{
+    intersect_and_bound_kernel kernels[3];
+    const char *names[3];
+    long long number_of_kernels=0;
+    if(prefetch_distance > 0)
+    {
+        return intersect_and_bound_prefetch;
+    }
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f"))
+    {
+        kernels[number_of_kernels]=intersect_and_bound_avx512;
+        names[number_of_kernels++]="avx512";
+    }
+    if(__builtin_cpu_supports("avx2"))
+    {
+        kernels[number_of_kernels]=intersect_and_bound_avx2;
+        names[number_of_kernels++]="avx2";
+    }
+#endif
+    kernels[number_of_kernels]=intersect_and_bound_scalar;
+    names[number_of_kernels++]="scalar";
+    double least[3]={0,0,0};
+    for(long long r=0;r<rounds;r++)
+    {
+        /* the kernels take turns, so that a slow spell of the machine
+           is shared by all of them */
+        for(long long k=0;k<number_of_kernels;k++)
+        {
+            double sec=time(kernels[k]);
+            if(r == 0 || sec < least[k])
+            {
+                least[k]=sec;
+            }
+        }
+    }
+    long long fastest=0;
+    for(long long k=1;k<number_of_kernels;k++)
+    {
+        if(least[k] < least[fastest])
+        {
+            fastest=k;
+        }
+    }
+    selected_isa = names[fastest];
+    return kernels[fastest];
+}
+
+const char *intersect_and_bound_isa()
+{
+    return selected_isa;
+}
@@ -0,0 +1,36 @@
+#ifndef intersection_kernels_h
+#define intersection_kernels_h
+
+/*
+   set2[j] = set[j] & adjv[j] for 0 <= j < size
+   <args>
+    tables: the block holding the optimal tables
+    table_offset: table_offset[j] is the index in tables of the first entry
+                  of the table of word j
+   <return>
+    the sum of tables[table_offset[j]+set2[j]]
+ */
+typedef long long (*intersect_and_bound_kernel)(const long long *set,const long long *adjv,
+        long long size,long long *set2,const long long *tables,const long long *table_offset);
+
+intersect_and_bound_kernel select_intersect_and_bound(long long distance);
+
+/*
+   Choose the fastest of the kernels the processor supports, unless the
+   prefetching pipeline is selected: time(kernel) measures a kernel on
+   the tables of the graph, rounds times in turn, and the least time of
+   each kernel counts; the widest kernel wins a tie.
+ */
+intersect_and_bound_kernel select_fastest_intersect_and_bound(double (*time)(intersect_and_bound_kernel kernel),
+        long long rounds);
+
+/*
+   the scalar kernel, prefetching the table slot of the word distance
+   places ahead of the one added to the bound (0: no prefetching)
+ */
+long long intersect_and_bound_ahead(const long long *set,const long long *adjv,
+        long long size,long long *set2,const long long *tables,const long long *table_offset,
+        long long distance);
+const char *intersect_and_bound_isa();
+
+#endif
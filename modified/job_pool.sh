@@ -0,0 +1,53 @@
+#!/bin/bash
+# Solve one graph through split, solve-job and merge on a local pool of processes.
+# Each job starts from the heaviest clique of the results written so far.
+# usage: ./job_pool.sh graph_file [workers [subset_size_limit [lower_bound]]]
+if [ $# -lt 1 ]
+then
+	echo "usage: $0 graph_file [workers [subset_size_limit [lower_bound]]]"
+	exit 1
+fi
+
+graph_file=$1
+workers=${2:-`nproc`}
+limit=${3:--1}
+lower_bound=${4:-0}
+
+directory=`mktemp -d`
+./otclique --lower-bound $lower_bound split $graph_file $directory $limit || exit 1
+if ! ls $directory/*.job > /dev/null 2>&1; then
+    # every root branch is bounded by the lower bound
+    rm -r $directory
+    printf "Maximum weight = 0\nThe maximum weight clique has 0 vertices,\n [ ]\n"
+    echo "No clique is heavier than the lower bound $lower_bound"
+    exit 0
+fi
+echo $lower_bound > $directory/best
+
+# a job raises the best weight by renaming a file, so a worker always
+# reads a weight some job has reached, if not the latest one; the raises
+# are serialised by a lock on the directory, so that a lighter weight is
+# never renamed over a heavier one
+solve_job() {
+    best=`cat $directory/best`
+    ./otclique --lower-bound $best solve-job $graph_file $1 ${1%.job}.part $limit > /dev/null || return
+    mv ${1%.job}.part ${1%.job}.result
+    weight=`grep '^w ' ${1%.job}.result | cut -d ' ' -f2`
+    (
+        flock 9
+        if [ $weight -gt `cat $directory/best` ]; then
+            echo $weight > $1.best && mv $1.best $directory/best
+        fi
+    ) 9< $directory
+}
+export -f solve_job
+export graph_file limit directory
+
+ls $directory/*.job | xargs -P $workers -n 1 bash -c 'solve_job "$0"'
+result=`./otclique merge $graph_file $directory/*.result`
+rm -r $directory
+echo "$result"
+weight=`echo "$result" | grep '^Maximum weight' | cut -d ' ' -f4`
+if [ "$weight" = 0 ] && ! echo "$result" | grep -q '^TIMEOUT'; then
+    echo "No clique is heavier than the lower bound $lower_bound"
+fi
@@ -0,0 +1,478 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "jobs.h"
+#include "otclique.h"
+#include "clique.h"
+#include "weighted_graph.h"
+#include "c_program_timing.h"
+
+typedef struct
+{
+    long long vertex; /* the root vertex of the branch */
+    long long *candidates;
+    long long size; /* the number of candidates */
+    long long bound; /* the upper bound of the cliques of the branch */
+    long long estimate; /* the estimated size of the search, the edges among the candidates */
+} job;
+
+static weighted_graph *graph;
+static job *jobs;
+static long long number_of_jobs;
+static long long pruned_jobs; /* root branches bounded by the lower bound */
+
+long long is_job_command(const char *name)
+{
+    return strcmp(name,"split") == 0 || strcmp(name,"solve-job") == 0 || strcmp(name,"merge") == 0;
+}
+
+/*
+   the subset size limit of a command line argument, -1 or missing for the default
+ */
+static long long subset_size_limit(const char *arg)
+{
+    long long limit=arg == NULL ? -1 : atoll(arg);
+    if(limit == -1)
+    {
+        limit=graph->n <= 1500 ? 25 : 20;
+    }
+    return limit;
+}
+
+/*
+   print a clique the way the solver does
+ */
+static void print_result(clique *result)
+{
+    printf("Maximum weight = %lld\n", result->weight);
+    printf("The maximum weight clique has %lld vertices,\n [",result->size);
+    for(long long i = 0; i < result->size; ++i)
+    {
+        printf(" %lld", result->set[i]+1);
+    }
+    printf(" ]\n");
+
+    if (is_timeout_flag_set())
+        fprintf(stdout, "TIMEOUT\n");
+
+    printf("%lld %lld %ld\n", result->size, result->weight, get_elapsed_time_msec());
+}
+
+static void collect_job(long long vertex,const long long *candidates,long long size,long long bound)
+{
+    if(bound <= get_initial_record())
+    {
+        ++pruned_jobs;
+        return;
+    }
+    job *j=&jobs[number_of_jobs++];
+    j->vertex=vertex;
+    j->size=size;
+    j->bound=bound;
+    j->candidates=(long long *)malloc(sizeof(long long)*(size > 0 ? size : 1));
+    memcpy(j->candidates,candidates,sizeof(long long)*size);
+    j->estimate=0;
+    for(long long a=0;a<size;a++)
+    {
+        long long *adj=graph->adjacency_matrix[candidates[a]];
+        for(long long b=a+1;b<size;b++)
+        {
+            j->estimate+=adj[candidates[b]] != 0;
+        }
+    }
+}
+
+/*
+   the largest estimate first, then the largest bound
+ */
+static int comp_job_size_nonincreasing(const void *j1,const void *j2)
+{
+    const job *a=(const job *)j1;
+    const job *b=(const job *)j2;
+    if(a->estimate != b->estimate)
+    {
+        return a->estimate < b->estimate ? 1 : -1;
+    }
+    if(a->bound != b->bound)
+    {
+        return a->bound < b->bound ? 1 : -1;
+    }
+    return a->vertex < b->vertex ? -1 : a->vertex > b->vertex;
+}
+
+static int split(const char *directory,long long limit)
+{
+    if(mkdir(directory,0777) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr,"Can't create \"%s\"\n",directory);
+        return 1;
+    }
+    jobs=(job *)malloc(sizeof(job)*(graph->n > 0 ? graph->n : 1));
+    number_of_jobs=0;
+    pruned_jobs=0;
+    enumerate_root_branches(graph,limit,collect_job);
+    qsort(jobs,number_of_jobs,sizeof(job),comp_job_size_nonincreasing);
+
+    char *path=(char *)malloc(strlen(directory)+32);
+    for(long long k=0;k<number_of_jobs;k++)
+    {
+        job *j=&jobs[k];
+        sprintf(path,"%s/%06lld.job",directory,k+1);
+        FILE *fp=fopen(path,"w");
+        if(fp == NULL)
+        {
+            fprintf(stderr,"Can't write \"%s\"\n",path);
+            return 1;
+        }
+        fprintf(fp,"c root branch of vertex %lld, subset size limit %lld\n",j->vertex+1,limit);
+        fprintf(fp,"j %lld %lld\n",k+1,number_of_jobs);
+        fprintf(fp,"u %lld\n",j->bound);
+        fprintf(fp,"s %lld\n",j->estimate);
+        fprintf(fp,"k %lld\n",j->vertex+1);
+        for(long long i=0;i<j->size;i++)
+        {
+            fprintf(fp,"v %lld\n",j->candidates[i]+1);
+        }
+        fclose(fp);
+        free(j->candidates);
+    }
+    printf("Jobs = %lld written to %s (%lld root branches bounded by the lower bound %lld)\n",
+            number_of_jobs, directory, pruned_jobs, get_initial_record());
+    if(number_of_jobs > 0)
+    {
+        printf("Estimated job sizes = %lld to %lld candidate edges\n",
+                jobs[number_of_jobs-1].estimate, jobs[0].estimate);
+    }
+    free(path);
+    free(jobs);
+    return 0;
+}
+
+/*
+   The lines of job and result files.
+    c COMMENT: ignored
+    j INDEX COUNT: the job INDEX of COUNT jobs of a split
+    u BOUND: the upper bound of the job
+    s SIZE: the estimated size of the job
+    k V: a vertex of the clique (the prefix of a job)
+    v V: a candidate of a job
+    t 0|1: 1 if the search of the job timed out
+    w WEIGHT: the weight of the clique of a result, 0 if none beat the lower bound
+   Vertices are numbered from 1, as in the graph file.
+ */
+typedef struct
+{
+    long long index;
+    long long count;
+    long long bound;
+    long long timeout;
+    long long weight;
+    long long *clique;
+    long long clique_size;
+    long long *candidates;
+    long long size;
+    long long clique_capacity;
+    long long capacity;
+} job_file;
+
+/*
+   append vertex v, numbered from 1, to an array of *size vertices
+ */
+static void append_vertex(long long **vertices,long long *size,long long *capacity,long long v)
+{
+    if(*size == *capacity)
+    {
+        *capacity*=2;
+        *vertices=(long long *)realloc(*vertices,sizeof(long long)*(*capacity));
+    }
+    (*vertices)[(*size)++]=v-1;
+}
+
+static long long read_job_file(const char *path,job_file *file)
+{
+    FILE *fp=fopen(path,"r");
+    if(fp == NULL)
+    {
+        fprintf(stderr,"Can't read \"%s\"\n",path);
+        return 0;
+    }
+    memset(file,0,sizeof(*file));
+    file->clique_capacity=64;
+    file->capacity=64;
+    file->clique=(long long *)malloc(sizeof(long long)*file->clique_capacity);
+    file->candidates=(long long *)malloc(sizeof(long long)*file->capacity);
+    char form;
+    long long ok=1;
+    while(ok && fscanf(fp," %c",&form) != EOF)
+    {
+        long long value;
+        switch(form)
+        {
+            case 'c':
+                ok=fscanf(fp,"%*[^\n]") == 0;
+                break;
+            case 'j':
+                ok=fscanf(fp,"%lld %lld",&file->index,&file->count) == 2;
+                break;
+            case 'u':
+                ok=fscanf(fp,"%lld",&file->bound) == 1;
+                break;
+            case 's':
+                ok=fscanf(fp,"%lld",&value) == 1;
+                break;
+            case 't':
+                ok=fscanf(fp,"%lld",&file->timeout) == 1;
+                break;
+            case 'w':
+                ok=fscanf(fp,"%lld",&file->weight) == 1;
+                break;
+            case 'k':
+            case 'v':
+                ok=fscanf(fp,"%lld",&value) == 1 && value >= 1;
+                if(ok && form == 'k')
+                {
+                    append_vertex(&file->clique,&file->clique_size,&file->clique_capacity,value);
+                }
+                else if(ok)
+                {
+                    append_vertex(&file->candidates,&file->size,&file->capacity,value);
+                }
+                break;
+            default:
+                ok=0;
+                break;
+        }
+    }
+    fclose(fp);
+    if(!ok || file->count < 1 || file->index < 1 || file->index > file->count)
+    {
+        fprintf(stderr,"\"%s\" is not a job or result file\n",path);
+        free(file->clique);
+        free(file->candidates);
+        return 0;
+    }
+    return 1;
+}
+
+/*
+   <return>
+    1 if every vertex of the file is a vertex of the graph, otherwise 0
+ */
+static long long in_graph(const job_file *file)
+{
+    for(long long i=0;i<file->clique_size;i++)
+    {
+        if(file->clique[i] >= graph->n)
+        {
+            return 0;
+        }
+    }
+    for(long long i=0;i<file->size;i++)
+    {
+        if(file->candidates[i] >= graph->n)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static long long clique_weight(const long long *vertices,long long size)
+{
+    long long sum=0;
+    for(long long i=0;i<size;i++)
+    {
+        sum+=graph->weight[vertices[i]];
+    }
+    return sum;
+}
+
+/*
+   Solve a job; the graph is read only if the bound of the job is above
+   the lower bound.
+   <args>
+    argv: graph, job and result files, then the optional subset size limit
+ */
+static int solve_job(int argc,char *argv[])
+{
+    const char *job_path=argv[1];
+    const char *result_path=argv[2];
+    job_file file;
+    if(!read_job_file(job_path,&file))
+    {
+        return 1;
+    }
+    long long lower=get_initial_record();
+
+    /* the clique of the job is its prefix and a clique of the candidates */
+    clique *result=(clique *)malloc(sizeof(clique));
+    result->set=(long long *)malloc(sizeof(long long)*(file.clique_size+file.size+1));
+    memcpy(result->set,file.clique,sizeof(long long)*file.clique_size);
+    result->size=file.clique_size;
+    result->weight=0;
+    if(file.bound > lower)
+    {
+        graph=read_graph(argv[0]);
+        if(!in_graph(&file))
+        {
+            fprintf(stderr,"\"%s\" is not a job of \"%s\"\n",job_path,argv[0]);
+            return 1;
+        }
+        result->weight=clique_weight(file.clique,file.clique_size);
+    }
+    if(file.size > 0 && file.bound > lower)
+    {
+        long long prefix_weight=result->weight;
+        long long limit=subset_size_limit(argc > 3 ? argv[3] : NULL);
+        weighted_graph *subgraph=create_vertex_induced_subgraph(file.candidates,file.size,graph);
+        long long target=get_target_weight();
+        set_initial_record(lower > prefix_weight ? lower-prefix_weight : 0);
+        if(target > 0)
+        {
+            set_target_weight(target > prefix_weight ? target-prefix_weight : 1);
+        }
+        clique *found=otclique(subgraph,limit);
+        set_initial_record(lower);
+        set_target_weight(target);
+        for(long long i=0;i<found->size;i++)
+        {
+            result->set[result->size++]=file.candidates[found->set[i]];
+        }
+        result->weight+=found->weight;
+        free(subgraph->adjacency_matrix);
+        free(subgraph->weight);
+        free(subgraph);
+        free(found->set);
+        free(found);
+    }
+    if(result->weight <= lower)
+    {
+        result->size=0;
+        result->weight=0;
+    }
+
+    FILE *fp=fopen(result_path,"w");
+    if(fp == NULL)
+    {
+        fprintf(stderr,"Can't write \"%s\"\n",result_path);
+        return 1;
+    }
+    fprintf(fp,"c result of %s, lower bound %lld\n",job_path,lower);
+    fprintf(fp,"j %lld %lld\n",file.index,file.count);
+    fprintf(fp,"t %d\n",is_timeout_flag_set() ? 1 : 0);
+    fprintf(fp,"w %lld\n",result->weight);
+    for(long long i=0;i<result->size;i++)
+    {
+        fprintf(fp,"k %lld\n",result->set[i]+1);
+    }
+    fclose(fp);
+
+    print_result(result);
+    free(result->set);
+    free(result);
+    free(file.clique);
+    free(file.candidates);
+    return 0;
+}
+
+static int merge(int number_of_results,char *result_paths[])
+{
+    clique *best=(clique *)malloc(sizeof(clique));
+    best->set=(long long *)malloc(sizeof(long long)*(graph->n > 0 ? graph->n : 1));
+    best->size=0;
+    best->weight=0;
+    long long count=0;
+    long long timeouts=0;
+    char *seen=NULL;
+    for(int r=0;r<number_of_results;r++)
+    {
+        job_file file;
+        if(!read_job_file(result_paths[r],&file))
+        {
+            return 1;
+        }
+        if(seen == NULL)
+        {
+            count=file.count;
+            seen=(char *)calloc(count,1);
+        }
+        clique found={file.clique_size,file.weight,file.clique};
+        if(file.count != count || !in_graph(&file) || !is_clique(&found,graph)
+                || clique_weight(file.clique,file.clique_size) != file.weight)
+        {
+            fprintf(stderr,"\"%s\" does not belong to the split or holds no clique of its weight\n",result_paths[r]);
+            return 1;
+        }
+        seen[file.index-1]=1;
+        timeouts+=file.timeout != 0;
+        if(file.weight > best->weight)
+        {
+            memcpy(best->set,file.clique,sizeof(long long)*file.clique_size);
+            best->size=file.clique_size;
+            best->weight=file.weight;
+        }
+        free(file.clique);
+        free(file.candidates);
+    }
+    long long merged=0;
+    for(long long k=0;k<count;k++)
+    {
+        merged+=seen[k];
+    }
+    printf("Jobs = %lld of %lld merged, %lld timed out\n", merged, count, timeouts);
+    if(merged < count || timeouts > 0)
+    {
+        /* the clique is not proved optimal */
+        set_timeout_flag();
+    }
+    print_result(best);
+    free(seen);
+    free(best->set);
+    free(best);
+    return 0;
+}
+
+int run_job_command(int argc,char *argv[])
+{
+    const char *command=argv[0];
+    long long needed=strcmp(command,"split") == 0 ? 3 : strcmp(command,"solve-job") == 0 ? 4 : 3;
+    if(argc < needed)
+    {
+        fprintf(stderr,"Usage: otclique [options] split file directory [subset_size_limit]\n"
+                "       otclique [options] solve-job file job result [subset_size_limit [time_limit]]\n"
+                "       otclique merge file result...\n");
+        return 1;
+    }
+    set_start_time();
+    int status;
+    graph=NULL;
+    if(strcmp(command,"split") == 0)
+    {
+        graph=read_graph(argv[1]);
+        status=split(argv[2],subset_size_limit(argc > 3 ? argv[3] : NULL));
+    }
+    else if(strcmp(command,"solve-job") == 0)
+    {
+        if(argc > 5)
+        {
+            set_time_limit_sec(atoi(argv[5]));
+        }
+        status=solve_job(argc-1,argv+1);
+    }
+    else
+    {
+        graph=read_graph(argv[1]);
+        status=merge(argc-2,argv+2);
+    }
+    if(graph != NULL)
+    {
+        free(graph->adjacency_matrix);
+        free(graph->weight);
+        free(graph);
+    }
+    return status;
+}
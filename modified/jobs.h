@@ -0,0 +1,33 @@
+#ifndef jobs_h
+#define jobs_h
+
+/*
+   One solve spread over independent jobs, each a root branch of the
+   search of the whole graph, for machines that share no memory.
+    split graph directory [subset_size_limit]:
+        write a job file per root branch to directory, the largest
+        estimated job first.
+    solve-job graph job result [subset_size_limit [time_limit]]:
+        search one job for a clique heavier than --lower-bound and write
+        the result file.
+    merge graph result...:
+        take the heaviest clique of the result files; it is optimal if
+        every job of the split has a result and none timed out.
+ */
+
+/*
+   <return>
+    1 if name is split, solve-job or merge, otherwise 0
+ */
+long long is_job_command(const char *name);
+
+/*
+   Run a job command.
+   <args>
+    argc, argv: the command and its arguments, the options removed
+   <return>
+    the exit status of the program
+ */
+int run_job_command(int argc,char *argv[]);
+
+#endif
@@ -27,6 +27,9 @@
 #include "weighted_graph.h"
 #include "clique.h"
 #include "otclique.h"
+#include "search_options.h"
+#include "portfolio.h"
+#include "jobs.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -37,6 +40,11 @@ int main(int argc, char *argv[])
 {
     long long limit;
     weighted_graph *input_graph;
+    argc=parse_search_options(argc,argv);
+    if(argc > 1 && is_job_command(argv[1]))
+    {
+        return run_job_command(argc-1,argv+1);
+    }
     switch (argc)
     {
         case 4 :
@@ -75,12 +83,13 @@ int main(int argc, char *argv[])
             }
             break;
         default:
-            fprintf(stderr,"Usage: %s file [subset_size_limit]\n",argv[0]);
+            fprintf(stderr,"Usage: %s [options] file [subset_size_limit]\n",argv[0]);
             return 1;
     }
 
     set_start_time();
-    clique *maximum_weight_clique=otclique(input_graph,limit);
+    clique *maximum_weight_clique=portfolio_size() > 0 ?
+        solve_portfolio(input_graph,limit) : otclique(input_graph,limit);
     long elapsed = get_elapsed_time_msec();
 
     printf("Maximum weight = %lld\n", maximum_weight_clique->weight);
@@ -27,6 +27,8 @@
 #include "weighted_graph.h"
 #include "clique.h"
 #include "otclique.h"
+#include "search_options.h"
+#include "portfolio.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -35,6 +37,7 @@ int main(int argc, char *argv[])
 {
     long long limit;
     weighted_graph *input_graph;
+    argc=parse_search_options(argc,argv);
     switch (argc)
     {
         case 3 :
@@ -53,12 +56,13 @@ int main(int argc, char *argv[])
             }
             break;
         default:
-            fprintf(stderr,"Usage: %s file [subset_size_limit]\n",argv[0]);
+            fprintf(stderr,"Usage: %s [options] file [subset_size_limit]\n",argv[0]);
             return 1;
     }
 
     weighted_graph *complement_graph = get_complement_graph(input_graph);
-    clique *maximum_weight_clique=otclique(complement_graph,limit);
+    clique *maximum_weight_clique=portfolio_size() > 0 ?
+        solve_portfolio(complement_graph,limit) : otclique(complement_graph,limit);
 
     long long all_weight_sum = 0;
     {
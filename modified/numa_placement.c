@@ -0,0 +1,262 @@
+#define _GNU_SOURCE
+
+#include <sched.h>
+#include <pthread.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef HAVE_LIBNUMA
+#include <numa.h>
+#endif
+#include "numa_placement.h"
+
+static numa_placement_mode placement = NUMA_PLACEMENT_DEFAULT;
+
+static const char *placement_names[] = {"default", "interleave", "replicate"};
+
+void set_numa_placement(numa_placement_mode mode)
+{
+    placement = mode;
+}
+
+numa_placement_mode get_numa_placement()
+{
+    return placement;
+}
+
+/*
+   parse a placement name given on the command line
+   <return>
+    1 if name is a known placement, otherwise 0
+ */
+long long parse_numa_placement(const char *name,numa_placement_mode *mode)
+{
+    for(long long i = 0; i < 3; ++i)
+    {
+        if(strcmp(name,placement_names[i]) == 0)
+        {
+            *mode = (numa_placement_mode)i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+const char *numa_placement_name(numa_placement_mode mode)
+{
+    return placement_names[mode];
+}
+
+#ifdef HAVE_LIBNUMA
+static long long libnuma_is_usable()
+{
+    return numa_available() != -1;
+}
+
+/*
+   the IDs of the nodes this process may allocate on, in increasing
+   order; node IDs may have gaps where nodes are offline
+ */
+static int *node_ids=NULL;
+static long long number_of_node_ids=0;
+
+static void find_node_ids()
+{
+    if(node_ids != NULL)
+    {
+        return;
+    }
+    struct bitmask *allowed=numa_get_mems_allowed();
+    int max_node=numa_max_node();
+    node_ids=(int *)malloc(sizeof(int)*(max_node+1));
+    for(int node=0;node<=max_node;node++)
+    {
+        if(numa_bitmask_isbitset(allowed,node))
+        {
+            node_ids[number_of_node_ids++]=node;
+        }
+    }
+    numa_bitmask_free(allowed);
+    if(number_of_node_ids == 0)
+    {
+        node_ids[number_of_node_ids++]=0;
+    }
+}
+#endif
+
+/*
+   the number of nodes this process may allocate on.
+   Without libnuma the machine is treated as a single node,
+   and every replica is placed by first touch.
+ */
+long long numa_number_of_nodes()
+{
+#ifdef HAVE_LIBNUMA
+    if(libnuma_is_usable())
+    {
+        find_node_ids();
+        return number_of_node_ids;
+    }
+#endif
+    return 1;
+}
+
+/*
+   <return>
+    the index of the node of a worker among the numa_number_of_nodes()
+    nodes, which is not its node ID
+ */
+long long numa_node_of_worker(long long worker)
+{
+    return worker % numa_number_of_nodes();
+}
+
+/*
+   the CPUs the process may run on, taken before any worker is pinned,
+   for the pinning without libnuma
+ */
+static int *allowed_cpus=NULL;
+static long long number_of_allowed_cpus=0;
+static pthread_once_t allowed_cpus_once=PTHREAD_ONCE_INIT;
+
+static void find_allowed_cpus()
+{
+    cpu_set_t cpus;
+    allowed_cpus=(int *)malloc(sizeof(int)*CPU_SETSIZE);
+    if(sched_getaffinity(0,sizeof(cpus),&cpus) != 0)
+    {
+        perror("sched_getaffinity");
+        return;
+    }
+    for(int cpu=0;cpu<CPU_SETSIZE;cpu++)
+    {
+        if(CPU_ISSET(cpu,&cpus))
+        {
+            allowed_cpus[number_of_allowed_cpus++]=cpu;
+        }
+    }
+}
+
+/*
+   Pin the calling thread.
+   Workers are spread over the nodes round-robin, so that worker w
+   reads the replica of node numa_node_of_worker(w); without libnuma
+   they are spread over the CPUs the process may run on.
+   Nothing is done with the default placement.
+ */
+void numa_pin_worker(long long worker)
+{
+    if(placement == NUMA_PLACEMENT_DEFAULT)
+    {
+        return;
+    }
+#ifdef HAVE_LIBNUMA
+    if(libnuma_is_usable())
+    {
+        find_node_ids();
+        int node=node_ids[numa_node_of_worker(worker)];
+        if(numa_run_on_node(node) != 0)
+        {
+            fprintf(stderr,"Can't pin worker %lld to node %d: %s\n",worker,node,strerror(errno));
+        }
+        numa_set_localalloc();
+        return;
+    }
+#endif
+    pthread_once(&allowed_cpus_once,find_allowed_cpus);
+    if(number_of_allowed_cpus == 0)
+    {
+        return;
+    }
+    int cpu=allowed_cpus[worker % number_of_allowed_cpus];
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu,&cpus);
+    if(sched_setaffinity(0,sizeof(cpus),&cpus) != 0)
+    {
+        fprintf(stderr,"Can't pin worker %lld to CPU %d: %s\n",worker,cpu,strerror(errno));
+    }
+}
+
+/*
+   allocate a block for read-only precomputed data
+   <args>
+    size: size of the block in bytes
+    node: the index of the node of the replica, as numa_node_of_worker()
+          gives it (used only by NUMA_PLACEMENT_REPLICATE)
+   <return>
+    the block, which must be released by numa_free_placed()
+ */
+void *numa_alloc_placed(size_t size,long long node)
+{
+    void *block = NULL;
+#ifdef HAVE_LIBNUMA
+    if(libnuma_is_usable() && placement != NUMA_PLACEMENT_DEFAULT)
+    {
+        if(placement == NUMA_PLACEMENT_INTERLEAVE)
+        {
+            block = numa_alloc_interleaved(size);
+        }
+        else
+        {
+            find_node_ids();
+            block = numa_alloc_onnode(size,node_ids[node]);
+        }
+    }
+    else
+#endif
+    {
+        block = malloc(size);
+    }
+    if(block == NULL)
+    {
+        fprintf(stderr,"Can't allocate %zu bytes for precomputed tables\n",size);
+        exit(1);
+    }
+    return block;
+}
+
+/*
+   Place a block of shared memory that has not been touched yet, as
+   numa_alloc_placed() places its blocks: interleaved over all nodes, or
+   on the node of a replica.  Without libnuma the pages are placed by
+   first touch.
+   <args>
+    node: the index of the node of the replica, as numa_node_of_worker()
+          gives it (used only by NUMA_PLACEMENT_REPLICATE)
+ */
+void numa_place_shared(void *block,size_t size,long long node)
+{
+#ifdef HAVE_LIBNUMA
+    if(libnuma_is_usable() && placement != NUMA_PLACEMENT_DEFAULT)
+    {
+        if(placement == NUMA_PLACEMENT_INTERLEAVE)
+        {
+            numa_interleave_memory(block,size,numa_all_nodes_ptr);
+        }
+        else
+        {
+            find_node_ids();
+            numa_tonode_memory(block,size,node_ids[node]);
+        }
+    }
+#else
+    (void)block;
+    (void)size;
+    (void)node;
+#endif
+}
+
+void numa_free_placed(void *block,size_t size)
+{
+#ifdef HAVE_LIBNUMA
+    if(libnuma_is_usable() && placement != NUMA_PLACEMENT_DEFAULT)
+    {
+        numa_free(block,size);
+        return;
+    }
+#endif
+    free(block);
+}
@@ -0,0 +1,33 @@
+#ifndef numa_placement_h
+#define numa_placement_h
+
+#include <stddef.h>
+
+/*
+   Placement of the read-only precomputed structures
+   (optimal tables and bit vector adjacency matrix).
+    NUMA_PLACEMENT_DEFAULT: plain malloc, pages land where they are first touched.
+    NUMA_PLACEMENT_INTERLEAVE: one copy, pages interleaved over all nodes.
+    NUMA_PLACEMENT_REPLICATE: one copy per node, each worker reads its local copy.
+ */
+typedef enum
+{
+    NUMA_PLACEMENT_DEFAULT,
+    NUMA_PLACEMENT_INTERLEAVE,
+    NUMA_PLACEMENT_REPLICATE
+} numa_placement_mode;
+
+void set_numa_placement(numa_placement_mode mode);
+numa_placement_mode get_numa_placement();
+long long parse_numa_placement(const char *name,numa_placement_mode *mode);
+const char *numa_placement_name(numa_placement_mode mode);
+
+long long numa_number_of_nodes();
+long long numa_node_of_worker(long long worker);
+void numa_pin_worker(long long worker);
+
+void *numa_alloc_placed(size_t size,long long node);
+void numa_place_shared(void *block,size_t size,long long node);
+void numa_free_placed(void *block,size_t size);
+
+#endif
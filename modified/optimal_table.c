@@ -26,8 +26,9 @@
 
 #include <stdlib.h>
 #include "weighted_graph.h"
+#include "cpu_kernels.h"
 
-static long long *mwc_solve_by_dp(weighted_graph *graph);
+static void mwc_solve_by_dp(weighted_graph *graph,long long *table);
 
 /*
    create optimal table
@@ -37,14 +38,26 @@ static long long *mwc_solve_by_dp(weighted_graph *graph);
     graph: a graph. vertices must be already reordered and re-indexed.
     limit: the limit size of each subsets
    <return>
-    the optimal table
+    the optimal table. the tables of the subsets follow each other in one
+    block starting at optimal_table[0], which is freed with
+    free_optimal_table()
  */
 long long **create_optimal_table(long long *subset_size,long long number_of_subsets,weighted_graph *graph,long long limit)
 {
-    long long **optimal_table=(long long **)malloc(number_of_subsets * sizeof(long long *));
+    long long **optimal_table=(long long **)malloc((number_of_subsets > 0 ? number_of_subsets : 1) * sizeof(long long *));
+    size_t total=0;
+    for(long long i = 0; i < number_of_subsets; ++i)
+    {
+        total+=(size_t)1 << subset_size[i];
+    }
+    optimal_table[0]=(long long *)malloc((total > 0 ? total : 1)*sizeof(long long));
 
     for(long long i = 0; i < number_of_subsets; ++i) 
     {
+        if(i > 0)
+        {
+            optimal_table[i]=optimal_table[i-1]+((long long)1 << subset_size[i-1]);
+        }
         long long length=subset_size[i];
         long long *seq = (long long*)malloc(length*sizeof(long long));
         for(long long j = 0; j < length; ++j)
@@ -52,7 +65,7 @@ long long **create_optimal_table(long long *subset_size,long long number_of_subs
             seq[j] = limit * i + j;
         }
         weighted_graph *graph2 = create_vertex_induced_subgraph(seq,length,graph);
-        optimal_table[i]=mwc_solve_by_dp(graph2);
+        mwc_solve_by_dp(graph2,optimal_table[i]);
 
         free(graph2->adjacency_matrix);
         free(graph2->weight);
@@ -62,14 +75,19 @@ long long **create_optimal_table(long long *subset_size,long long number_of_subs
     return optimal_table;
 }
 
+void free_optimal_table(long long **optimal_table)
+{
+    free(optimal_table[0]);
+    free(optimal_table);
+}
+
 /*
    calculate all exact solutions of all subgraphs of givin graph
    <args>
     graph: a vertex-weighted graph. the number of vertex must be less than sizeof(long long)
-   <return>
-    a part of the optimal table
+    table: a part of the optimal table, of 2^n entries, to fill
  */
-static long long *mwc_solve_by_dp(weighted_graph *graph)
+static void mwc_solve_by_dp(weighted_graph *graph,long long *table)
 {
     long long n = graph->n;
     long long *weight=graph->weight;
@@ -87,22 +105,12 @@ static long long *mwc_solve_by_dp(weighted_graph *graph)
     }
 
     /* initialize table */
-    long long *table = (long long*)malloc((1<<n)*sizeof(long long));
     table[0] = 0;
 
     /* dynamic programming */
     for(long long i = 0; i < n; ++i) 
     {
-        long long start = 1 << i;
-        long long end = 1 << (i+1);
-        long long adji = adj0[i];
-        long long weighti = weight[i];
-        for(long long j = start; j < end; ++j) 
-        {
-            long long unused = table[j-start];
-            long long used =  table[adji & j] + weighti;
-            table[j] = unused < used ? used : unused;
-        }
+        dp_sweep(table,1 << i,adj0[i],weight[i]);
     }
 
     for(long long i = 0; i < n; ++i)
@@ -111,5 +119,4 @@ static long long *mwc_solve_by_dp(weighted_graph *graph)
     }
     free(adjacency_matrix);
     free(adj0);
-    return table;
 }
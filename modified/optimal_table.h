@@ -29,5 +29,6 @@
 
 #include "weighted_graph.h"
 long long **create_optimal_table(long long *subset_size,long long number_of_subsets,weighted_graph *graph,long long limit);
+void free_optimal_table(long long **optimal_table);
 
 #endif
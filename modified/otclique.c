@@ -24,349 +24,4490 @@
 
 ==================================================================================*/
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "clique.h"
 #include "otclique.h"
 #include "weighted_graph.h"
 #include "optimal_table.h"
 #include "vertex_sequence_and_partition.h"
+#include "numa_placement.h"
+#include "intersection_kernels.h"
+#include "cpu_kernels.h"
 #include <time.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <memory.h>
+#include <string.h>
 #include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
 
 #include "c_program_timing.h"
+#include "shared_record.h"
+
+/* the largest candidate set the single-word solver can hold */
+#define SMALL_SET_MAX 64
 
-static clock_t start_precomputation;
-static clock_t end_precomuputation;
-static clock_t start_branch_and_bound;
-static clock_t end_branch_and_bound;
-static unsigned long branch_count;
+static double start_precomputation;
+static double end_precomuputation;
+static double start_branch_and_bound;
+static double end_branch_and_bound;
 static long long **adjacency_matrix;
 static long long *weight;
 static long long *c;
-static long long *record;
-static long long record_weight;
-static long long record_size;
-static long long *current;
-static long long current_size;
-static long long current_weight;
+static _Atomic long long own_record_weight;
+static _Atomic long long *record_weight=&own_record_weight; /* the published record, shared with other processes by set_shared_record() */
+static record_listener listener=NULL; /* called with each clique before it is published */
+static long long initial_record=0; /* only cliques heavier than this are searched for */
+static long long target_weight=0; /* the search stops at a clique of this weight, 0 if it never does */
+static atomic_bool target_reached; /* true once a clique of target_weight is published */
+static long long target_at_final=1; /* nonzero if the record is raised to the target only for the final search */
+static double gap=0; /* a branch is pruned unless it can beat the record by this ratio */
+static long long open_upper_bound; /* the bound of the maximum weight a stopped search leaves, -1 if it finished */
+static sequence_ordering ordering=ORDER_BY_GRAPH;
+static const char *ordering_names[] = {"graph", "weighted", "unweighted"};
+static unsigned long total_branch_count; /* the recursive calls of the last run */
 static long long **optimal_table;
+static long long *table_offset; /* the index of each table in the block of optimal_table[0], the same in every replica */
 static long long limit;
-static long long *msb_table;
 static long long weighted;
 static long long number_of_subsets,*subset_size;
 static weighted_graph *input_graph;
 static weighted_graph *reconstructed_graph;
 static long long *seq=NULL;
+static long long *word_count; /* the number of words of the bit vector of each vertex */
+static long long *word_neighbours; /* the neighbours of each vertex in its own subset */
+static branching_policy branching=BRANCH_MSB;
+static const char *branching_names[] = {"msb", "max-weight", "max-degree", "max-reduction"};
+static long long summary_words; /* the number of summary words of a candidate set */
+static long long set_length; /* number_of_subsets plus summary_words */
+static long long use_summaries; /* nonzero if only the live words of candidate sets are visited */
+static intersect_and_bound_kernel intersect_and_bound; /* kernel for long dense sets */
+static long long prefetch_distance=0; /* 0 if table slots are not prefetched */
+static long long lookup_benchmark_rounds=0;
+static long long number_of_threads=1;
+static long long interleaved_lanes=1; /* root branches searched at once by one thread */
+static long long small_set_limit=0; /* candidate sets up to this size are solved in one word, 0 if none */
+static long long delta_bound=0; /* nonzero if the bound of a child is derived from the bound of its parent */
+static long long dominance_depth=0; /* nodes with at most this many clique vertices delete dominated candidates */
+static long long lookahead_depth=0; /* the deepest nodes propagation_bound() may reach, 0 if none */
+static long long deterministic=0; /* nonzero if the threads search root branches in fixed rounds */
+static long long speculative_c=0; /* nonzero if the threads solve the prefix problems of c[] ahead of its commits */
+static double c_stop_fraction=0; /* the fraction of the vertices with exact c[], 0 for the default of the graph */
+static long long adaptive_c_stop=0; /* nonzero if the end of the c[] phase is chosen while it runs */
+static long long repartition_depth=0; /* nodes with at most this many clique vertices may be repartitioned, 0 if none */
+static long long number_of_contexts; /* the threads, then the interleaved lanes */
+static long long number_of_processes=1; /* solver processes, each searching a slice of the root branches */
+static long long process_index=0; /* the slice of this process, 0 in the coordinator */
+
+/* the subset size limits for which expand() is specialised */
+#define SPECIALISED_LIMITS(X) \
+    X(1) X(2) X(3) X(4) X(5) X(6) X(7) X(8) X(9) X(10) \
+    X(11) X(12) X(13) X(14) X(15) X(16) X(17) X(18) X(19) X(20) \
+    X(21) X(22) X(23) X(24) X(25) X(26) X(27) X(28) X(29) X(30)
+
+/* the summaries of candidate sets are used on graphs with at least
+   this many subsets and an edge density below SUMMARY_MAX_DENSITY */
+#define SUMMARY_MIN_SUBSETS 32
+#define SUMMARY_MAX_DENSITY 0.5
+
+/* dense candidate sets with at least this many words are intersected by intersect_and_bound */
+#define SIMD_MIN_WORDS 16
+
+/* the intersection kernel is chosen by the least time of this many
+   timings of each, of this many table lookups */
+#define INTERSECTION_TIMING_ROUNDS 5
+#define INTERSECTION_TIMING_LOOKUPS (1<<16)
+
+/* the most solver processes of --processes */
+#define MAX_PROCESSES 64
+
+/* a process waiting for the others wakes this often to look for failed processes */
+#define PROCESS_WATCH_NANOSECONDS 10000000
+
+/* the adaptive c[] phase ends no earlier than this fraction of the vertices,
+   and judges the last C_STOP_WINDOW of them (at least C_STOP_MIN_WINDOW prefixes) */
+#define C_STOP_MIN_FRACTION 0.7
+#define C_STOP_WINDOW 0.1
+#define C_STOP_MIN_WINDOW 4
+
+/* the prefetch distance compared by the lookup benchmark when none is set */
+#define BENCHMARK_PREFETCH_DISTANCE 8
+
+/* root nodes with fewer candidates are searched by one thread */
+#define PARALLEL_MIN_CANDIDATES 32
+
+/* the depth of the propagation bound is revised after this many tries at
+   the deepest depth: one deeper at a prune rate of LOOKAHEAD_RAISE_RATE,
+   one shallower below LOOKAHEAD_LOWER_RATE */
+#define LOOKAHEAD_WINDOW 256
+#define LOOKAHEAD_RAISE_RATE 0.10
+#define LOOKAHEAD_LOWER_RATE 0.02
+
+/* nodes with REPARTITION_MIN to REPARTITION_MAX candidates may be
+   repartitioned, into subsets of at most REPARTITION_TABLE_BITS vertices */
+#define REPARTITION_MIN 32
+#define REPARTITION_MAX 256
+#define REPARTITION_TABLE_BITS 12
+
+/* a node is repartitioned if the mean number of recursive calls in the
+   subtrees searched with fresh tables, times REPARTITION_ENTRIES_PER_CALL,
+   is at least the number of table entries its candidates may need; one
+   node in REPARTITION_SAMPLE_PERIOD is repartitioned regardless, to follow
+   the mean */
+#define REPARTITION_ENTRIES_PER_CALL 64
+#define REPARTITION_SAMPLE_PERIOD 64
+
+/*
+   a copy of the read-only precomputed structures in one placed block
+ */
+typedef struct
+{
+    long long **optimal_table;
+    long long **adjacency_matrix;
+    void *block; /* NULL when the structures are used where they were built */
+    size_t block_size;
+    long long shared; /* nonzero if block is shared memory mapped by the solver processes */
+} placed_tables;
+static placed_tables *replica=NULL; /* one per node */
+static long long number_of_replicas;
+
+/*
+   a node on the explicit stack of expand()
+ */
+typedef struct
+{
+    long long *set; /* the candidate words, in the arena */
+    long long i; /* the word being branched on */
+    long long upper; /* the upper bound of the remaining candidates */
+    long long vertex; /* the vertex of the branch being searched below */
+} expand_frame;
+
+/*
+   the loop state of expand(): the node being branched on and the
+   current clique, which is written back to the context before the
+   calls that read it
+ */
+typedef struct
+{
+    long long *set;
+    unsigned long long *live; /* the summary of set */
+    long long i; /* the word being branched on */
+    long long upper;
+    long long depth; /* the depth of the node on the explicit stack */
+    long long current_size;
+    long long current_weight;
+} search_cursor;
+
+/*
+   a search node whose branches can be taken by any thread.
+   steal_depth is the size of current while branches are left,
+   so that idle threads can find the shallowest frame without locking.
+ */
+typedef struct
+{
+    long long *set;
+    long long set_size;
+    long long upper;
+    long long i; /* the word of set being branched on */
+    long long *current;
+    long long current_size;
+    long long current_weight;
+    long long exhausted;
+    long long sliced; /* nonzero if the branches are dealt round-robin to the processes */
+    long long branch_index; /* the branches taken or skipped so far, while sliced */
+    _Atomic long long steal_depth;
+    pthread_mutex_t lock;
+} shared_frame;
+
+/* a thread shares at most this many nested nodes */
+#define MAX_SHARED_FRAMES 16
+
+/*
+   the state of one search thread.
+   The candidate set of a node whose current clique has d vertices lives
+   in level d of the arena, so the search does no heap allocation.
+   The best clique found by a thread stays in its own record;
+   only its weight is published through record_weight.
+   frames[0..frames_top) is the deque of nodes this thread shares,
+   from the shallowest to the deepest.
+ */
+typedef struct
+{
+    long long worker;
+    long long **optimal_table;
+    long long **adjacency_matrix;
+    long long *current;
+    long long current_size;
+    long long current_weight;
+    long long *record;
+    long long record_size;
+    long long record_weight;
+    long long *arena; /* candidate sets of the recursion, one level per clique size */
+    expand_frame *stack; /* the nodes of expand(), one per clique size */
+    shared_frame *frames;
+    _Atomic long long frames_top;
+    unsigned long branch_count;
+    unsigned long c_prunes; /* branches cut by c[] */
+    long long root_word; /* the word of the last root branch of the final search, -1 before the first */
+    long long *outsiders; /* 2*number_of_subsets scratch words of delete_dominated() */
+    unsigned long dominated_count; /* candidates deleted by delete_dominated() */
+    long long *lookahead; /* 2*number_of_subsets scratch words of propagation_bound() */
+    long long lookahead_limit; /* nodes up to this depth try propagation_bound() */
+    long long lookahead_window_tries; /* tries at depth lookahead_limit in this window */
+    long long lookahead_window_prunes;
+    unsigned long lookahead_tries;
+    unsigned long lookahead_prunes;
+    _Atomic long long *incumbent; /* record_weight, or private_incumbent while a prefix is re-solved */
+    _Atomic long long private_incumbent;
+    long long found_weight; /* the heaviest clique ctx has published */
+    long long deferred; /* nonzero while the records of ctx are committed at the end of a round */
+    struct local_partition *partition; /* scratch of repartition_node(), NULL if unused */
+    unsigned long repartition_tries;
+    unsigned long repartition_prunes; /* nodes pruned by the bound of the recoloring */
+    unsigned long repartition_count; /* nodes searched with fresh tables */
+    unsigned long repartition_calls; /* recursive calls in their subtrees */
+    double repartition_mean_calls; /* moving mean of the calls per subtree, -1 before the first */
+    unsigned long repartition_visits; /* nodes seen by the cost model of repartition_node() */
+    double repartition_sec; /* time spent recoloring and building fresh tables */
+    unsigned long small_set_count; /* nodes searched by solve_small_set() */
+    unsigned long delta_abandons; /* child bounds abandoned by intersect_candidates_by_delta() */
+} search_context;
+static search_context *contexts;
+
+/*
+   The search of a root branch interleaved with other lanes on one thread.
+   The cursor of expand() is kept here between the steps of the lane;
+   a step ends when the candidate set of a child has been intersected and
+   its table slots prefetched, and the bound is summed in the next step,
+   after the other lanes have issued their own lookups.
+ */
+typedef struct
+{
+    search_context *ctx;
+    long long active;
+    search_cursor cursor;
+    long long base; /* the depth of the root branch */
+    long long *set2; /* the child waiting for its bound, or NULL */
+    long long set2_size;
+    long long vertex; /* the vertex of the child */
+} search_lane;
+static search_lane *lanes;
+
+static shared_frame *active_frame; /* the root node searched by all threads */
+static long long sharing; /* nonzero while all threads search active_frame */
+static _Atomic long long busy_threads;
+static _Atomic unsigned long long frames_pushed; /* counts the frames pushed, for the idle threads */
+static pthread_mutex_t idle_lock;
+static pthread_cond_t work_changed; /* signalled on a push while threads are idle, and when none is busy */
+static long long split_depth=3;
+static long long speculating; /* nonzero while the threads solve prefix problems */
+static pthread_barrier_t frame_start;
+static pthread_barrier_t frame_finish;
+static pthread_barrier_t round_barrier; /* the rounds of the deterministic schedule */
+static pthread_mutex_t turn_lock;
+static pthread_cond_t turn_changed;
+static long long turn; /* the thread taking its branch of the round */
+static long long committed_record; /* the record all threads start a round with */
+static long long last_round; /* nonzero once the root frame is exhausted at the end of a round */
+static unsigned long number_of_rounds;
+static pthread_t *worker_threads;
+
+/*
+   The prefix problems of the c[] phase solved ahead of the frontier.
+   Prefix l is the problem of the l-th vertex of the sequence.  The
+   threads claim prefixes in order through next, and c[] of prefix l is
+   committed, by the thread holding lock, only after every earlier prefix.
+ */
+typedef struct
+{
+    long long number_of_prefixes;
+    long long *vertex; /* the vertex of each prefix */
+    long long *found; /* the heaviest clique found in each prefix */
+    long long *incumbent; /* the incumbent when each prefix was solved */
+    long long *solved; /* nonzero once a prefix awaits its commit */
+    long long next; /* the first prefix not claimed */
+    long long committed; /* the prefixes whose c[] is exact */
+    unsigned long solved_again;
+    pthread_mutex_t lock;
+} prefix_queue;
+static prefix_queue prefixes;
+
+typedef struct
+{
+    long long number_of_vertices;
+    long long length; /* the prefixes whose c[] is exact */
+    unsigned long *calls; /* the recursive calls before each prefix */
+    unsigned long *prunes; /* the branches cut by c[] before each prefix */
+    double projected; /* the cost estimate that ended an adaptive phase, 0 if none did */
+    double discounted;
+} c_phase_log;
+static c_phase_log c_phase;
+
+/*
+   the state of one solver process in shared memory
+ */
+typedef struct
+{
+    pid_t pid;
+    long long finished; /* nonzero once the search of the process is over */
+    long long reaped; /* nonzero once the coordinator has waited for the process */
+    unsigned long branch_count;
+    unsigned long c_prunes;
+    long long open_bound; /* open_upper_bound of the process */
+} process_slot;
+
+/*
+   The memory shared by the solver processes.  The coordinator is process
+   0 and solves a slice too.  done[l] counts the processes past prefix l
+   of the c[] phase; c[] of the prefix is read once it reaches
+   number_of_processes.  It is raised under lock, which done_changed
+   is signalled with.
+ */
+typedef struct
+{
+    _Atomic long long failed; /* nonzero once a process died */
+    pid_t coordinator;
+    pthread_mutex_t lock;
+    pthread_cond_t done_changed;
+    process_slot slot[MAX_PROCESSES];
+    _Atomic long long done[];
+} process_group;
+static process_group *group=NULL;
+static size_t group_size;
+static shared_record *process_record=NULL; /* the best clique of all processes, in the vertices of the sequence */
 
 static void precomputation();
+static void place_precomputed_tables();
+static void free_precomputed_tables();
+static void free_unplaced_tables();
+static long long adjacency_length(long long v);
+static inline long long with_gap(long long record);
 static void branch_and_bound();
-static void expand(long long *set,long long set_size,long long upper);
+static void expand(search_context *ctx,long long *set,long long set_size,long long upper);
+static void (*expand_kernel)(search_context *ctx,long long *set,long long set_size,long long upper);
+static void select_expand_kernel();
+static void select_kernels();
+static void choose_intersection_kernel();
+static void benchmark_table_lookups();
+static void expand_shared(search_context *ctx,long long *set,long long set_size,long long upper);
+static long long enter_node(search_context *ctx,long long *set,long long set_size,long long upper);
+static long long lookahead_may_beat_record(search_context *ctx,long long *set,long long set_size,long long upper);
+static void alloc_local_partition(search_context *ctx);
+static void free_local_partition(search_context *ctx);
+static void search_interleaved(shared_frame *frame);
+static void speculate_prefixes(search_context *ctx);
+static void fork_processes();
+static void wait_for_processes(long long l);
+static void finish_processes();
+static void release_processes();
+static long long adaptive_stop();
+static long long speculates_c();
 
-clique * otclique(weighted_graph *graph,long long subset_size_limit)
+/*
+   nonzero once the time limit has expired or a clique of the target weight is published
+ */
+static inline long long search_stopped()
 {
-    double sec_precomputation;
-    double sec_branch_and_bound;
-    double sec_total;
-    clique *maximum_weight_clique;
-    long long n=graph->n;
-    branch_count=0;
-    input_graph=graph;
-    limit=subset_size_limit;
+    return atomic_load_explicit(&target_reached,memory_order_acquire) || is_timeout_flag_set();
+}
 
-    printf("Subset size limit = %lld\n", limit);
-    start_precomputation=clock();
+/*
+   Check the time limit, and the record published by other processes
+   against the target weight.
+ */
+static void check_for_stop()
+{
+    check_for_timeout();
+    if(target_weight > 0 && atomic_load_explicit(record_weight,memory_order_relaxed) >= target_weight)
+    {
+        atomic_store_explicit(&target_reached,true,memory_order_release);
+    }
+}
+
+/*
+   the candidate set of a node whose current clique has depth vertices
+ */
+static long long *arena_level(search_context *ctx,long long depth)
+{
+    return ctx->arena + depth*set_length;
+}
+
+/*
+   A candidate set is stored as number_of_subsets words followed by its
+   summary: bit j of the summary is set if and only if word j is nonzero.
+   When use_summaries is set, only the words marked in the summary are
+   valid, so that the search never touches the words which have become
+   empty; otherwise the summary is not maintained below the root.
+ */
+static inline unsigned long long *live_words(long long *set)
+{
+    return (unsigned long long *)(set+number_of_subsets);
+}
 
-    /* check if the graph is weighted or unweighted */
+/*
+   build the summary of the first set_size words of a candidate set
+ */
+static void summarize_set(long long *set,long long set_size)
+{
+    unsigned long long *live=live_words(set);
+    memset(live,0,sizeof(unsigned long long)*summary_words);
+    for(long long j=0;j<set_size;j++)
     {
-        weighted=0;
-        long long weight0=graph->weight[0];
-        long long *weight=graph->weight;
-        for(long long i=0;i<n;i++)
+        if(set[j] != 0)
         {
-            if(weight0 != weight[i])
-            {
-                weighted=1;
-                break;
-            }
+            live[j>>6] |= 1ULL<<(j&63);
         }
     }
+}
 
-    /* create msb_table to get msb of any bit vector */
-    msb_table = (long long *)malloc((1 << limit)*sizeof(long long));
-    msb_table[0] = -1;
-    for(long long i = 0; i < limit; ++i) 
+/*
+   <return>
+    the largest nonzero word j <= i of a candidate set, or -1
+ */
+static inline __attribute__((always_inline))
+long long highest_live_word(long long *set,const unsigned long long *live,long long i,const long long summarised)
+{
+    if(!summarised)
     {
-        long long from = 1 << i;
-        long long to = 1 << (i + 1);
-        for(long long j = from; j < to; ++j) 
+        while(i >= 0 && set[i] == 0)
         {
-            msb_table[j] = i;
+            i--;
         }
+        return i;
     }
-
-    /* precomputation phase */
-    precomputation();
-
-    end_precomuputation=clock();
-    sec_precomputation=(double)(end_precomuputation-start_precomputation)/CLOCKS_PER_SEC;
-    printf("%lld subsets created from %lld vertices \n", number_of_subsets, n);
-    /* print record */
-    printf("Precomputation phase = %.2f sec.\n",
-            sec_precomputation);
-
-    start_branch_and_bound=clock();
-    /* branch-and-bound phase */
-    branch_and_bound();
-
-    end_branch_and_bound=clock();
-    sec_branch_and_bound=(double)(end_branch_and_bound-start_branch_and_bound)/CLOCKS_PER_SEC;
-    sec_total=(double)(end_branch_and_bound-start_precomputation)/CLOCKS_PER_SEC;
-
-    /* print record */
-    printf("Branch-and-bound phase = %.2f sec.\n",
-            sec_branch_and_bound);
-    printf("Branch-and-bound iterations = %ld (recursive calls)\n",
-            branch_count);
-    printf("Total time = %.2f sec.\n", sec_total);
-
-    maximum_weight_clique=(clique *)malloc(sizeof(clique));
-    maximum_weight_clique->size=record_size;
-    maximum_weight_clique->weight=record_weight;
-    maximum_weight_clique->set=(long long *)malloc(sizeof(long long) * record_size);
-    for(long long i = 0; i < record_size; ++i)
+    if(i < 0)
+    {
+        return -1;
+    }
+    long long w=i>>6;
+    unsigned long long m=live[w] & (~0ULL >> (63-(i&63)));
+    while(m == 0)
     {
-        maximum_weight_clique->set[i]=seq[record[i]];
+        if(--w < 0)
+        {
+            return -1;
+        }
+        m=live[w];
     }
+    return (w<<6) + 63-__builtin_clzll(m);
+}
 
-    for(long long i = 0;i<number_of_subsets;i++)
+/*
+   set2 = set & adjv on the first set2_size words, with the table slots
+   of set2 prefetched; the step of a lane before the bound is summed
+ */
+static inline __attribute__((always_inline))
+void intersect_and_prefetch(long long *set,long long *adjv,long long set2_size,
+        long long *set2,long long **optimal_table,const long long summarised)
+{
+    if(!summarised)
     {
-        free(optimal_table[i]);
+        for(long long j=0;j<set2_size;j++)
+        {
+            set2[j] = set[j] & adjv[j];
+            __builtin_prefetch(&optimal_table[j][set2[j]]);
+        }
+        return;
     }
-    free(optimal_table);
-    free(msb_table);
+    unsigned long long *live=live_words(set);
+    unsigned long long *live2=live_words(set2);
+    for(long long w=0;w<<6 < set2_size;w++)
     {
-        long long n_r=reconstructed_graph->n;
-        for(long long i=0; i<n_r; i++)
+        unsigned long long m=live[w];
+        unsigned long long m2=0;
+        if(set2_size-(w<<6) < 64)
         {
-            free(adjacency_matrix[i]);
+            m &= (1ULL<<(set2_size-(w<<6)))-1;
+        }
+        while(m != 0)
+        {
+            long long b=__builtin_ctzll(m);
+            long long j=(w<<6)+b;
+            long long word=set[j] & adjv[j];
+            m &= m-1;
+            set2[j]=word;
+            m2 |= (unsigned long long)(word != 0) << b;
+            __builtin_prefetch(&optimal_table[j][word]);
         }
+        live2[w]=m2;
     }
-    free(adjacency_matrix);
-    free(reconstructed_graph->adjacency_matrix);
-    free(reconstructed_graph);
-    free(seq);
-    free(subset_size);
-    free(record);
-    free(weight);
-    return maximum_weight_clique;
 }
 
 /*
-   Precomputation phase.
-   1. Make a vertex sequence and partition.
-   2. Make the optimal tables.
+   the upper bound of the first set2_size words of a candidate set;
+   the step of a lane after intersect_and_prefetch()
  */
-static void precomputation()
+static inline __attribute__((always_inline))
+long long candidate_bound(long long *set2,long long set2_size,long long **optimal_table,const long long summarised)
 {
-    /* make a vertex sequence and partition */
-    sequence_and_partition *seq_and_partition;
-    if(weighted)
+    long long upper=0;
+    if(!summarised)
     {
-        seq_and_partition=coloring_weighted(input_graph,limit);
+        for(long long j=0;j<set2_size;j++)
+        {
+            upper+=optimal_table[j][set2[j]];
+        }
+        return upper;
     }
-    else
+    unsigned long long *live2=live_words(set2);
+    for(long long w=0;w<<6 < set2_size;w++)
     {
-        seq_and_partition=coloring_unweighted(input_graph,limit);
+        unsigned long long m=live2[w];
+        while(m != 0)
+        {
+            long long j=(w<<6)+__builtin_ctzll(m);
+            m &= m-1;
+            upper+=optimal_table[j][set2[j]];
+        }
     }
+    return upper;
+}
 
-    long long *seq0=seq_and_partition->sequence;
-    number_of_subsets=seq_and_partition->number_of_subsets;
-    subset_size = seq_and_partition->subset_size;
-    free(seq_and_partition);
-
-    /* encode to bit vector*/
-    seq=(long long *)calloc(number_of_subsets*limit,sizeof(long long));
+/*
+   the live words of the first set2_size words of a summarised set, in
+   increasing order: *w and *m are the word of the summary and its bits
+   not yet visited
+   <return>
+    the next live word
+ */
+static inline __attribute__((always_inline))
+long long next_live_word(unsigned long long *live,long long set2_size,long long *w,unsigned long long *m)
+{
+    while(*m == 0)
     {
-        long long k=0;
-        for(long long i=0;i<number_of_subsets;i++)
+        ++*w;
+        *m=live[*w];
+        if(set2_size-(*w<<6) < 64)
         {
-            long long h=i*limit;
-            for(long long l=0;l<subset_size[i];l++)
-            {
-                seq[h++]=seq0[k++];
-            }
+            *m &= (1ULL<<(set2_size-(*w<<6)))-1;
         }
     }
-    free(seq0);
-    reconstructed_graph=create_vertex_induced_subgraph(seq,number_of_subsets*limit,input_graph);
-    adjacency_matrix=get_bit_vector_adjacency_matrix(reconstructed_graph,limit);
-    weight=reconstructed_graph->weight;
-
-    /* create optimal tables */
-    optimal_table=create_optimal_table(subset_size,number_of_subsets,reconstructed_graph,limit);
+    long long j=(*w<<6)+__builtin_ctzll(*m);
+    *m &= *m-1;
+    return j;
 }
 
 /*
-   Branch-and-bound phase.
+   intersect_candidates() of a summarised set with prefetching: the
+   table slot of each live word is prefetched prefetch_distance live
+   words ahead of the one added to the bound.
+   <return>
+    the upper bound of set2 given by the optimal tables
  */
-static void branch_and_bound()
+static inline __attribute__((always_inline))
+long long intersect_live_ahead(long long *set,long long *adjv,long long set2_size,
+        long long *set2,long long **optimal_table)
 {
-    long long n=input_graph->n;
-
-    /* initialize variables used in branch-and-bound phase */
-    record=(long long *)malloc(sizeof(long long)*n);
-    record_weight=0;
-    record_size=0;
-    current = (long long *)malloc(sizeof(long long)*n);
-    c = (long long *)malloc(sizeof(long long) * (number_of_subsets*limit));
-    for(long long i=0;i<number_of_subsets*limit;i++)
+    unsigned long long *live=live_words(set);
+    unsigned long long *live2=live_words(set2);
+    long long upper=0;
+    long long pending=0; /* live words prefetched but not added */
+    long long sw=-1; /* the summation follows the live words of set */
+    unsigned long long sm=0;
+    for(long long w=0;w<<6 < set2_size;w++)
     {
-        c[i]=LLONG_MAX/2;
+        unsigned long long m=live[w];
+        unsigned long long m2=0;
+        if(set2_size-(w<<6) < 64)
+        {
+            m &= (1ULL<<(set2_size-(w<<6)))-1;
+        }
+        while(m != 0)
+        {
+            long long b=__builtin_ctzll(m);
+            long long j=(w<<6)+b;
+            long long word=set[j] & adjv[j];
+            m &= m-1;
+            set2[j]=word;
+            m2 |= (unsigned long long)(word != 0) << b;
+            __builtin_prefetch(&optimal_table[j][word]);
+            if(++pending > prefetch_distance)
+            {
+                long long k=next_live_word(live,set2_size,&sw,&sm);
+                upper+=optimal_table[k][set2[k]];
+                --pending;
+            }
+        }
+        live2[w]=m2;
     }
-
-    long long stop=n;
-    if(weighted)
+    while(pending-- > 0)
     {
-        stop=n*0.8;
+        long long k=next_live_word(live,set2_size,&sw,&sm);
+        upper+=optimal_table[k][set2[k]];
     }
+    return upper;
+}
 
-    /* main loop */
-    long long *set = (long long *)calloc(number_of_subsets,sizeof(long long));
+/*
+   set2 = set & adjv on the first set2_size words,
+   visiting live words only when the sets are summarised.
+   The bound is summed from scratch unless --child-bound delta selects
+   intersect_candidates_by_delta().
+   <return>
+    the upper bound of set2 given by the optimal tables
+ */
+static inline __attribute__((always_inline))
+long long intersect_candidates(long long *set,long long *adjv,long long set2_size,
+        long long *set2,long long **optimal_table,const long long summarised)
+{
+    unsigned long long *live=live_words(set);
+    unsigned long long *live2=live_words(set2);
+    long long upper=0;
+    if(!summarised)
     {
-        long long i=0;long long j=0;long long l=0;
-        for(i=0; i<number_of_subsets; i++)
+        if(set2_size >= SIMD_MIN_WORDS)
         {
-            for(;j<subset_size[i];j++)
-            {
-                if(l++==stop)
-                {
-                    goto nobs; /* stop calculation of c[] */
-                }
-                set[i] += (1<<j);
-                long long v = (i*limit) + j;
-                long long* adjv=adjacency_matrix[v];
-                long long* set2=(long long *)calloc(i+1,sizeof(long long));
-                long long upper=0;
-                long long k=(v-1)/limit+1;
-                while(k--)
-                {
-                    set2[k] = set[k] & adjv[k];
-                    upper+=optimal_table[k][set2[k]];
-                }
-                current_size=1;
-                current_weight=weight[v];
-                current[0]=v;
-                if(current_weight + upper > record_weight)
-                {
-                    expand(set2,i+1,upper);
-                }
-                free(set2);
-                c[v] = record_weight;
-            }
-            j=0;
+            return intersect_and_bound(set,adjv,set2_size,set2,optimal_table[0],table_offset);
         }
-nobs:
-        /*
-           Find the exact solution of the orignial input graph.
-         */
-        for(;i<number_of_subsets; i++)
+        long long j=set2_size;
+        while(j--)
         {
-            for(;j<subset_size[i];j++)
-            {
-                set[i] += (1<<j);
-            }
-            j=0;
+            set2[j] = set[j] & adjv[j];
+            upper+=optimal_table[j][set2[j]];
         }
-        long long upper=0;
-        for(long long i = 0; i < number_of_subsets; ++i)
+        return upper;
+    }
+    if(prefetch_distance > 0)
+    {
+        return intersect_live_ahead(set,adjv,set2_size,set2,optimal_table);
+    }
+    for(long long w=0;w<<6 < set2_size;w++)
+    {
+        unsigned long long m=live[w];
+        unsigned long long m2=0;
+        if(set2_size-(w<<6) < 64)
         {
-            upper += optimal_table[i][set[i]];
+            m &= (1ULL<<(set2_size-(w<<6)))-1;
         }
-        current_size = 0;
-        current_weight = 0;
-        if(current_weight + upper > record_weight)
+        while(m != 0)
         {
-            expand(set,number_of_subsets,upper);
+            long long b=__builtin_ctzll(m);
+            long long j=(w<<6)+b;
+            long long word=set[j] & adjv[j];
+            m &= m-1;
+            set2[j]=word;
+            m2 |= (unsigned long long)(word != 0) << b;
+            upper+=optimal_table[j][word];
         }
+        live2[w]=m2;
     }
-
-    free(set);
-    free(c);
-    free(current);
+    return upper;
 }
 
 /*
-   Branching procedure.
+   intersect_candidates() with the bound of set2 derived from the bound of
+   set: only the words from which adjv removes candidates are looked up,
+   twice, and the sum is abandoned as soon as it cannot exceed floor.
    <args>
-    set: a vertex subset
-    set_size: the size of "set"
-    upper: an upper bound of the graph induced by "set"
+    upper: the bound of set, the sum of the table entries of its words up
+           to word i, the word of the vertex branched on
+    floor: set2 is of no use unless its bound exceeds floor
+   <return>
+    the upper bound of set2, or a value not exceeding floor as soon as
+    the bound is known not to exceed floor (set2 is then left incomplete)
  */
-void expand(long long *set,long long set_size,long long upper)
+static inline __attribute__((always_inline))
+long long intersect_candidates_by_delta(long long *set,long long *adjv,long long set2_size,
+        long long *set2,long long **optimal_table,long long i,long long upper,long long floor,
+        const long long summarised)
 {
-    ++branch_count;
-    if (branch_count % 100000 == 0)
-        check_for_timeout();
-    if (is_timeout_flag_set())
-        return;
-
-    long long i=set_size;
-    while(i--)
+    unsigned long long *live=live_words(set);
+    unsigned long long *live2=live_words(set2);
+    if(set2_size == i)
+    {
+        /* the vertex is the first of its word, which set2 leaves out */
+        upper-=optimal_table[i][set[i]];
+    }
+    if(upper <= floor)
     {
-        while(set[i] != 0) 
+        return upper;
+    }
+    if(!summarised)
+    {
+        for(long long j=0;j<set2_size;j++)
         {
-            /* check upper bound of optimal tables */
-            if(current_weight + upper <= record_weight) 
-            {
-                return;
-            }
-            long long msb=msb_table[set[i]];
-            long long vertex = (i*limit) + msb;
-            /* check upper bound of c[]*/
-            if(current_weight + c[vertex] <= record_weight)
-            {
-                return;
-            }
-            /* add vertex to current */
-            current[current_size++] = vertex;
-            current_weight += weight[vertex];
-            /* make new set */
-            long long set2_size = (vertex-1)/limit+1;
-            if(vertex==0)
-            {
-                set2_size=0;
-            }
-            long long* set2 = (long long *)malloc(sizeof(long long)*set2_size);
-            long long *adjv = adjacency_matrix[vertex];
-            long long new_upper=0;
+            long long word=set[j] & adjv[j];
+            set2[j]=word;
+            if(word != set[j])
             {
-                long long j=set2_size;
-                while(j--)
+                upper-=optimal_table[j][set[j]]-optimal_table[j][word];
+                if(upper <= floor)
                 {
-                    set2[j] = set[j] & adjv[j];
-                    new_upper+=optimal_table[j][set2[j]];
+                    return upper;
                 }
             }
-            if(current_weight + new_upper > record_weight)
+        }
+        return upper;
+    }
+    for(long long w=0;w<<6 < set2_size;w++)
+    {
+        unsigned long long m=live[w];
+        unsigned long long m2=0;
+        if(set2_size-(w<<6) < 64)
+        {
+            m &= (1ULL<<(set2_size-(w<<6)))-1;
+        }
+        while(m != 0)
+        {
+            long long b=__builtin_ctzll(m);
+            long long j=(w<<6)+b;
+            long long word=set[j] & adjv[j];
+            m &= m-1;
+            set2[j]=word;
+            m2 |= (unsigned long long)(word != 0) << b;
+            if(word != set[j])
+            {
+                upper-=optimal_table[j][set[j]]-optimal_table[j][word];
+                if(upper <= floor)
+                {
+                    return upper;
+                }
+            }
+        }
+        live2[w]=m2;
+    }
+    return upper;
+}
+
+/*
+   <return>
+    the highest bit of a nonzero word of a candidate set
+ */
+static inline __attribute__((always_inline))
+long long msb_of(long long word)
+{
+    return 63-__builtin_clzll(word);
+}
+
+/*
+   delete the vertex with bit msb from word i of a candidate set
+ */
+static inline __attribute__((always_inline))
+void delete_candidate(long long *set,unsigned long long *live,long long i,long long msb,const long long summarised)
+{
+    set[i] -= 1<<msb;
+    if(summarised && set[i] == 0)
+    {
+        live[i>>6] &= ~(1ULL<<(i&63));
+    }
+}
+
+/*
+   the total weight of the neighbours of vertex v in a candidate set
+   whose highest nonzero word i holds v
+ */
+static long long weighted_degree(search_context *ctx,long long *set,long long i,long long v,const long long summarised)
+{
+    long long *adjv=ctx->adjacency_matrix[v];
+    long long degree=0;
+    for(long long m=set[i] & word_neighbours[v];m != 0;m &= m-1)
+    {
+        degree+=weight[i*limit+__builtin_ctzll(m)];
+    }
+    for(long long j=highest_live_word(set,live_words(set),i-1,summarised);j >= 0;j=highest_live_word(set,live_words(set),j-1,summarised))
+    {
+        for(long long m=set[j] & adjv[j];m != 0;m &= m-1)
+        {
+            degree+=weight[j*limit+__builtin_ctzll(m)];
+        }
+    }
+    return degree;
+}
+
+/*
+   choose the vertex of the highest nonzero word i of a candidate set to
+   branch on; ties go to the later vertex
+   <args>
+    msb: the highest bit of the word, the choice of BRANCH_MSB
+   <return>
+    the bit of the vertex in the word
+ */
+static inline __attribute__((always_inline))
+long long branch_bit(search_context *ctx,long long *set,long long i,long long msb,
+        const long long fixed_limit,const long long summarised)
+{
+    if(branching == BRANCH_MSB)
+    {
+        return msb;
+    }
+    long long word=set[i];
+    long long best=msb;
+    long long best_score=LLONG_MIN;
+    for(long long m=word;m != 0;m &= m-1)
+    {
+        long long b=__builtin_ctzll(m);
+        long long v=i*fixed_limit+b;
+        long long score;
+        if(branching == BRANCH_MAX_WEIGHT)
+        {
+            score=weight[v];
+        }
+        else if(branching == BRANCH_MAX_REDUCTION)
+        {
+            score=-ctx->optimal_table[i][word & ~(1LL<<b)];
+        }
+        else
+        {
+            score=weighted_degree(ctx,set,i,v,summarised);
+        }
+        if(score >= best_score)
+        {
+            best_score=score;
+            best=b;
+        }
+    }
+    return best;
+}
+
+/*
+   Delete the candidates dominated by vertex v, which has just been
+   branched on and deleted from a candidate set with highest nonzero
+   word i.  A candidate u is dominated if it weighs no more than v and
+   none of its neighbours in the set lies outside the neighbourhood of v:
+   a clique with u in the set becomes one at least as heavy in the branch
+   of v when u is replaced by v.
+   The neighbours of the outsiders are collected word by word, and the
+   candidates left are checked against the earlier outsiders.
+   <return>
+    the change of the table bound of the set
+ */
+static long long delete_dominated(search_context *ctx,long long *set,long long i,long long v,const long long summarised)
+{
+    long long **adjacency_matrix=ctx->adjacency_matrix;
+    long long **optimal_table=ctx->optimal_table;
+    unsigned long long *live=live_words(set);
+    long long *outsiders=ctx->outsiders;
+    long long *reached=ctx->outsiders+number_of_subsets; /* later neighbours of outsiders */
+    long long *adjv=adjacency_matrix[v];
+    long long delta=0;
+    for(long long j=0;j<i;j++)
+    {
+        long long valid = !summarised || ((live[j>>6]>>(j&63)) & 1);
+        outsiders[j] = valid ? set[j] & ~adjv[j] : 0;
+        reached[j]=0;
+    }
+    outsiders[i] = set[i] & ~word_neighbours[v];
+    reached[i]=0;
+    for(long long k=0;k<=i;k++)
+    {
+        for(long long m=outsiders[k];m != 0;m &= m-1)
+        {
+            long long w=k*limit+__builtin_ctzll(m);
+            long long *adjw=adjacency_matrix[w];
+            for(long long j=0;j<k;j++)
+            {
+                reached[j] |= adjw[j];
+            }
+            reached[k] |= word_neighbours[w];
+        }
+    }
+    for(long long j=0;j<=i;j++)
+    {
+        if(summarised && !((live[j>>6]>>(j&63)) & 1))
+        {
+            continue;
+        }
+        long long dominated=0;
+        for(long long m=set[j] & ~reached[j];m != 0;m &= m-1)
+        {
+            long long b=__builtin_ctzll(m);
+            long long u=j*limit+b;
+            long long *adju=adjacency_matrix[u];
+            long long k=0;
+            if(weight[u] > weight[v])
+            {
+                continue;
+            }
+            while(k < j && (adju[k] & outsiders[k]) == 0)
+            {
+                k++;
+            }
+            if(k == j)
+            {
+                dominated |= 1LL<<b;
+            }
+        }
+        if(dominated != 0)
+        {
+            delta-=optimal_table[j][set[j]];
+            set[j] &= ~dominated;
+            delta+=optimal_table[j][set[j]];
+            if(summarised && set[j] == 0)
+            {
+                live[j>>6] &= ~(1ULL<<(j&63));
+            }
+            ctx->dominated_count+=__builtin_popcountll(dominated);
+        }
+    }
+    return delta;
+}
+
+/*
+   The adjacency rows hold the earlier neighbours only, so the child of
+   a vertex below the msb of word i lacks the later candidates of the
+   word: put word i of set2 right, with its summary bit.
+   <return>
+    the change of the table bound of set2
+ */
+static inline __attribute__((always_inline))
+long long complete_word(long long *set,long long i,long long vertex,long long *set2,long long *set2_size,
+        long long **optimal_table,const long long summarised)
+{
+    unsigned long long *live2=live_words(set2);
+    long long delta=0;
+    if(*set2_size > i)
+    {
+        delta-=optimal_table[i][set2[i]];
+    }
+    else
+    {
+        if(summarised && (i&63) == 0)
+        {
+            live2[i>>6]=0;
+        }
+        *set2_size=i+1;
+    }
+    set2[i]=set[i] & word_neighbours[vertex];
+    delta+=optimal_table[i][set2[i]];
+    if(summarised)
+    {
+        live2[i>>6] = (live2[i>>6] & ~(1ULL<<(i&63))) | ((unsigned long long)(set2[i] != 0) << (i&63));
+    }
+    return delta;
+}
+
+/*
+   set the number of search threads (1 by default)
+ */
+void set_number_of_threads(long long threads)
+{
+    number_of_threads = threads < 1 ? 1 : threads;
+}
+
+/*
+   Nodes with fewer than depth vertices in the current clique are always
+   shared with other threads; deeper nodes are shared only while a thread is idle.
+ */
+void set_split_depth(long long depth)
+{
+    split_depth = depth;
+}
+
+/*
+   set the deepest nodes the propagation bound may be tried at (0 disables it)
+ */
+void set_lookahead_depth(long long depth)
+{
+    lookahead_depth = depth;
+}
+
+/*
+   nonzero to search the shared root frames in deterministic rounds
+ */
+void set_deterministic(long long fixed_rounds)
+{
+    deterministic = fixed_rounds;
+}
+
+/*
+   nonzero to compute c[] with speculative prefix problems on all threads
+ */
+void set_speculative_c(long long speculative)
+{
+    speculative_c = speculative;
+}
+
+/*
+   set the number of solver processes (1 by default)
+ */
+void set_number_of_processes(long long processes)
+{
+    number_of_processes = processes < 1 ? 1 : processes > MAX_PROCESSES ? MAX_PROCESSES : processes;
+}
+
+/*
+   set the fraction of the vertices whose prefix problems give c[]
+   (0 restores the default, 0.8 on weighted graphs and 1 otherwise)
+ */
+void set_c_stop_fraction(double fraction)
+{
+    c_stop_fraction = fraction;
+}
+
+/*
+   nonzero to choose the end of the c[] phase from the cost of the prefix problems
+ */
+void set_adaptive_c_stop(long long adaptive)
+{
+    adaptive_c_stop = adaptive;
+}
+
+/*
+   set the depth down to which candidate sets may be repartitioned (0 disables it)
+ */
+void set_repartition_depth(long long depth)
+{
+    repartition_depth = depth;
+}
+
+/*
+   publish the record weight through record, which other processes may
+   raise too; the caller initialises it
+ */
+void set_shared_record(_Atomic long long *record)
+{
+    record_weight = record;
+}
+
+/*
+   call record_found with every clique heavier than the published record
+   before its weight is published (NULL disables it)
+ */
+void set_record_listener(record_listener record_found)
+{
+    listener = record_found;
+}
+
+void set_sequence_ordering(sequence_ordering order)
+{
+    ordering = order;
+}
+
+/*
+   parse a vertex sequence ordering given on the command line
+   <return>
+    1 if name is a known ordering, otherwise 0
+ */
+long long parse_sequence_ordering(const char *name,sequence_ordering *order)
+{
+    for(long long i = 0; i < 3; ++i)
+    {
+        if(strcmp(name,ordering_names[i]) == 0)
+        {
+            *order = (sequence_ordering)i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+const char *sequence_ordering_name(sequence_ordering order)
+{
+    return ordering_names[order];
+}
+
+/*
+   search only for cliques heavier than weight (0 by default); if there
+   is none, otclique() returns the empty clique
+ */
+void set_initial_record(long long weight)
+{
+    initial_record = weight;
+}
+
+/*
+   <return>
+    the record a search starts from: the weight of set_initial_record(),
+    or the target weight less one if that is higher and not left to the
+    final search
+ */
+long long get_initial_record()
+{
+    if(target_at_final)
+    {
+        return initial_record;
+    }
+    return initial_record > target_weight-1 ? initial_record : target_weight-1;
+}
+
+/*
+   Decide if a clique of at least weight exists (0, the default, finds the
+   maximum): the search starts from the record weight-1 and stops at the
+   first clique of weight or more.  If none exists, otclique() returns the
+   empty clique.
+ */
+void set_target_weight(long long weight)
+{
+    target_weight = weight;
+}
+
+long long get_target_weight()
+{
+    return target_weight;
+}
+
+/*
+   Nonzero to raise the record to the target weight less one only for the
+   final search of the whole graph, after the prefix problems have given
+   exact c[] (the default; 0: from the first prefix problem on).
+ */
+void set_target_at_final(long long at_final)
+{
+    target_at_final = at_final;
+}
+
+/*
+   Prune a branch unless its bound exceeds the record times 1+ratio (0,
+   the default, prunes exactly).  The clique found then weighs at least
+   1/(1+ratio) of the maximum.  Bounds of c[] are compared with the plain
+   record, since c[] holds the weights the prefix problems found, which
+   are already within the ratio.
+ */
+void set_gap(double ratio)
+{
+    gap = ratio;
+}
+
+/*
+   <return>
+    the recursive calls of the last call of otclique()
+ */
+unsigned long last_branch_count()
+{
+    return total_branch_count;
+}
+
+/*
+   set the depth down to which dominated candidates are deleted (0 disables it)
+ */
+void set_dominance_depth(long long depth)
+{
+    dominance_depth = depth;
+}
+
+void set_branching_policy(branching_policy policy)
+{
+    branching = policy;
+}
+
+/*
+   parse a branching policy name given on the command line
+   <return>
+    1 if name is a known policy, otherwise 0
+ */
+long long parse_branching_policy(const char *name,branching_policy *policy)
+{
+    for(long long i = 0; i < 4; ++i)
+    {
+        if(strcmp(name,branching_names[i]) == 0)
+        {
+            *policy = (branching_policy)i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+const char *branching_policy_name(branching_policy policy)
+{
+    return branching_names[policy];
+}
+
+/*
+   set the number of root branches searched at once by one thread
+   (1 by default, the plain recursive search)
+ */
+void set_interleaved_lanes(long long count)
+{
+    interleaved_lanes = count;
+}
+
+/*
+   set the largest candidate set solved in one word (at most SMALL_SET_MAX,
+   0 by default, which disables the single-word solver)
+ */
+void set_small_set_limit(long long size)
+{
+    small_set_limit = size;
+}
+
+/*
+   Nonzero to derive the bound of a child from the bound of its parent,
+   looking up only the words the branch changes and abandoning the sum
+   once the child cannot beat the record (0 by default: summed from
+   scratch).  Children whose word of the vertex is completed after
+   reordering are still summed from scratch.
+ */
+void set_delta_bound(long long delta)
+{
+    delta_bound = delta;
+}
+
+/*
+   set how many words ahead the table slots are prefetched (0 by default,
+   which disables prefetching: the lookups of a candidate set are
+   independent, so out-of-order execution already overlaps them)
+ */
+void set_prefetch_distance(long long distance)
+{
+    prefetch_distance = distance;
+}
+
+/*
+   measure the table lookup rate in this many rounds before the search
+ */
+void set_lookup_benchmark(long long rounds)
+{
+    lookup_benchmark_rounds = rounds;
+}
+
+static double wall_clock()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC,&now);
+    return now.tv_sec + now.tv_nsec*1e-9;
+}
+
+/*
+   check if the graph is weighted or unweighted
+ */
+static long long is_weighted(weighted_graph *graph)
+{
+    long long weight0=graph->weight[0];
+    for(long long i=0;i<graph->n;i++)
+    {
+        if(weight0 != graph->weight[i])
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+clique * otclique(weighted_graph *graph,long long subset_size_limit)
+{
+    double sec_precomputation;
+    double sec_branch_and_bound;
+    double sec_total;
+    clique *maximum_weight_clique;
+    long long n=graph->n;
+    input_graph=graph;
+    limit=subset_size_limit;
+
+    printf("Subset size limit = %lld\n", limit);
+    select_kernels();
+    start_precomputation=wall_clock();
+
+    weighted=is_weighted(graph);
+
+    /* precomputation phase */
+    precomputation();
+    place_precomputed_tables();
+    choose_intersection_kernel();
+
+    end_precomuputation=wall_clock();
+    sec_precomputation=end_precomuputation-start_precomputation;
+    printf("%lld subsets created from %lld vertices \n", number_of_subsets, n);
+    /* print record */
+    printf("Precomputation phase = %.2f sec.\n",
+            sec_precomputation);
+
+    if(lookup_benchmark_rounds > 0)
+    {
+        benchmark_table_lookups();
+    }
+
+    start_branch_and_bound=wall_clock();
+    if(number_of_processes > 1)
+    {
+        fork_processes();
+    }
+    /* branch-and-bound phase */
+    branch_and_bound();
+    if(group != NULL)
+    {
+        finish_processes();
+    }
+
+    end_branch_and_bound=wall_clock();
+    sec_branch_and_bound=end_branch_and_bound-start_branch_and_bound;
+    sec_total=end_branch_and_bound-start_precomputation;
+
+    free_precomputed_tables();
+
+    /* print record */
+    printf("Branch-and-bound phase = %.2f sec.\n",
+            sec_branch_and_bound);
+    {
+        unsigned long branch_count=0;
+        for(long long t=0;t<number_of_contexts;t++)
+        {
+            branch_count+=contexts[t].branch_count;
+        }
+        printf("Branch-and-bound iterations = %ld (recursive calls)\n",
+                branch_count);
+        total_branch_count=branch_count;
+        if(interleaved_lanes > 1)
+        {
+            printf("Interleaved lanes = %lld\n", interleaved_lanes);
+        }
+        if(small_set_limit > 0)
+        {
+            unsigned long small_set_count=0;
+            for(long long t=0;t<number_of_contexts;t++)
+            {
+                small_set_count+=contexts[t].small_set_count;
+            }
+            printf("Small sets solved in one word = %lu\n", small_set_count);
+        }
+        if(delta_bound)
+        {
+            unsigned long delta_abandons=0;
+            for(long long t=0;t<number_of_contexts;t++)
+            {
+                delta_abandons+=contexts[t].delta_abandons;
+            }
+            printf("Child bounds abandoned early = %lu\n", delta_abandons);
+        }
+        if(lookahead_depth > 0)
+        {
+            unsigned long tries=0;
+            unsigned long prunes=0;
+            for(long long t=0;t<number_of_contexts;t++)
+            {
+                tries+=contexts[t].lookahead_tries;
+                prunes+=contexts[t].lookahead_prunes;
+            }
+            printf("Propagation bound = %lu prunes in %lu tries\n", prunes, tries);
+        }
+        if(c_phase.projected > 0)
+        {
+            printf("Russian-doll prefixes = %lld of %lld vertices (adaptive: %.3e calls projected > %.3e)\n",
+                    c_phase.length, input_graph->n, c_phase.projected, c_phase.discounted);
+        }
+        else
+        {
+            printf("Russian-doll prefixes = %lld of %lld vertices (%s)\n",
+                    c_phase.length, input_graph->n, adaptive_stop() ? "adaptive" : "fixed");
+        }
+        if(target_weight > 0)
+        {
+            printf("Target weight %lld = %s\n", target_weight,
+                    atomic_load(record_weight) >= target_weight ? "reached"
+                    : is_timeout_flag_set() ? "unknown (time limit)" : "no clique reaches it");
+        }
+        long long record=atomic_load(record_weight);
+        if(open_upper_bound == LLONG_MAX)
+        {
+            printf("Open upper bound = unknown (a process failed)\n");
+        }
+        else if(open_upper_bound >= 0)
+        {
+            printf("Open upper bound = %lld (gap %.2f%%)\n", open_upper_bound,
+                    record > 0 ? 100.0*(open_upper_bound-record)/record : 100.0);
+        }
+        else if(gap > 0)
+        {
+            printf("Optimality gap = %.2f%% (maximum weight at most %lld)\n",
+                    100.0*gap, with_gap(record));
+        }
+        if(deterministic && number_of_threads > 1)
+        {
+            printf("Deterministic rounds = %lu\n", number_of_rounds);
+        }
+        if(group != NULL)
+        {
+            for(long long p=0;p<number_of_processes;p++)
+            {
+                if(group->slot[p].finished)
+                {
+                    printf("Process %lld = %lu iterations\n", p, group->slot[p].branch_count);
+                }
+                else
+                {
+                    printf("Process %lld = failed\n", p);
+                }
+            }
+        }
+        if(speculates_c())
+        {
+            printf("Speculative prefixes solved again = %lu\n", prefixes.solved_again);
+        }
+        if(repartition_depth > 0)
+        {
+            unsigned long tries=0;
+            unsigned long prunes=0;
+            unsigned long count=0;
+            unsigned long calls=0;
+            double sec=0;
+            for(long long t=0;t<number_of_contexts;t++)
+            {
+                tries+=contexts[t].repartition_tries;
+                prunes+=contexts[t].repartition_prunes;
+                count+=contexts[t].repartition_count;
+                calls+=contexts[t].repartition_calls;
+                sec+=contexts[t].repartition_sec;
+            }
+            printf("Repartitioned nodes = %lu searched and %lu pruned in %lu tries\n", count, prunes, tries);
+            printf("Repartitioned subtrees = %lu recursive calls (%.1f%% of all), %.2f sec. recoloring\n",
+                    calls, branch_count > 0 ? 100.0*calls/branch_count : 0.0, sec);
+        }
+        if(dominance_depth > 0)
+        {
+            unsigned long dominated_count=0;
+            for(long long t=0;t<number_of_contexts;t++)
+            {
+                dominated_count+=contexts[t].dominated_count;
+            }
+            printf("Dominated candidates deleted = %lu\n", dominated_count);
+        }
+        if(ordering != ORDER_BY_GRAPH)
+        {
+            printf("Vertex sequence ordering = %s\n", sequence_ordering_name(ordering));
+        }
+        if(branching != BRANCH_MSB)
+        {
+            printf("Branching policy = %s\n", branching_policy_name(branching));
+        }
+        printf("Branch-and-bound throughput = %.3e calls/sec\n",
+                branch_count/sec_branch_and_bound);
+    }
+    printf("Total time = %.2f sec.\n", sec_total);
+
+    /* the thread holding the published record weight has the clique */
+    search_context *best=&contexts[0];
+    for(long long t=1;t<number_of_contexts;t++)
+    {
+        if(contexts[t].record_weight > best->record_weight)
+        {
+            best=&contexts[t];
+        }
+    }
+    if(best->record_weight < target_weight)
+    {
+        /* a lighter clique of the prefix problems does not answer the decision */
+        best->record_size=0;
+        best->record_weight=0;
+    }
+    maximum_weight_clique=(clique *)malloc(sizeof(clique));
+    maximum_weight_clique->size=best->record_size;
+    maximum_weight_clique->weight=best->record_weight;
+    maximum_weight_clique->set=(long long *)malloc(sizeof(long long) * best->record_size);
+    for(long long i = 0; i < best->record_size; ++i)
+    {
+        maximum_weight_clique->set[i]=seq[best->record[i]];
+    }
+    if(group != NULL)
+    {
+        release_processes();
+    }
+
+    free(reconstructed_graph->adjacency_matrix);
+    free(reconstructed_graph);
+    free(seq);
+    free(subset_size);
+    for(long long t=0;t<number_of_contexts;t++)
+    {
+        free(contexts[t].record);
+    }
+    free(contexts);
+    free(weight);
+    return maximum_weight_clique;
+}
+
+void enumerate_root_branches(weighted_graph *graph,long long subset_size_limit,root_branch_visitor visit)
+{
+    input_graph=graph;
+    limit=subset_size_limit;
+    weighted=is_weighted(graph);
+    precomputation();
+
+    long long n_r=number_of_subsets*limit;
+    long long *set=(long long *)malloc(sizeof(long long)*number_of_subsets);
+    long long *candidates=(long long *)malloc(sizeof(long long)*graph->n);
+    for(long long v=n_r-1;v>=0;v--)
+    {
+        long long i=v/limit;
+        long long j=v%limit;
+        if(j >= subset_size[i])
+        {
+            continue;
+        }
+        /* the candidates of the branch precede v in the sequence */
+        long long upper=0;
+        long long size=0;
+        for(long long k=0;k<adjacency_length(v);k++)
+        {
+            set[k]=adjacency_matrix[v][k] & ((1LL << subset_size[k])-1);
+            upper+=optimal_table[k][set[k]];
+            for(long long bits=set[k];bits != 0;bits&=bits-1)
+            {
+                candidates[size++]=seq[k*limit+__builtin_ctzll(bits)];
+            }
+        }
+        visit(seq[v],candidates,size,weight[v]+upper);
+    }
+    free(set);
+    free(candidates);
+
+    free_unplaced_tables();
+    free(table_offset);
+    free(reconstructed_graph->adjacency_matrix);
+    free(reconstructed_graph);
+    free(weight);
+    free(seq);
+    free(subset_size);
+}
+
+/*
+   Precomputation phase.
+   1. Make a vertex sequence and partition.
+   2. Make the optimal tables.
+ */
+static void precomputation()
+{
+    /* make a vertex sequence and partition */
+    sequence_and_partition *seq_and_partition;
+    if(ordering == ORDER_WEIGHTED || (ordering == ORDER_BY_GRAPH && weighted))
+    {
+        seq_and_partition=coloring_weighted(input_graph,limit);
+    }
+    else
+    {
+        seq_and_partition=coloring_unweighted(input_graph,limit);
+    }
+
+    long long *seq0=seq_and_partition->sequence;
+    number_of_subsets=seq_and_partition->number_of_subsets;
+    subset_size = seq_and_partition->subset_size;
+    free(seq_and_partition);
+
+    /* encode to bit vector*/
+    seq=(long long *)calloc(number_of_subsets*limit,sizeof(long long));
+    {
+        long long k=0;
+        for(long long i=0;i<number_of_subsets;i++)
+        {
+            long long h=i*limit;
+            for(long long l=0;l<subset_size[i];l++)
+            {
+                seq[h++]=seq0[k++];
+            }
+        }
+    }
+    free(seq0);
+    reconstructed_graph=create_vertex_induced_subgraph(seq,number_of_subsets*limit,input_graph);
+    adjacency_matrix=get_bit_vector_adjacency_matrix(reconstructed_graph,limit);
+    weight=reconstructed_graph->weight;
+
+    /* create optimal tables */
+    optimal_table=create_optimal_table(subset_size,number_of_subsets,reconstructed_graph,limit);
+    table_offset=(long long *)malloc(sizeof(long long)*(number_of_subsets > 0 ? number_of_subsets : 1));
+    for(long long i=0;i<number_of_subsets;i++)
+    {
+        table_offset[i]=optimal_table[i]-optimal_table[0];
+    }
+}
+
+/*
+   the length of the bit vector of vertex v in the adjacency matrix
+ */
+static long long adjacency_length(long long v)
+{
+    return v == 0 ? 1 : (v-1)/limit+1;
+}
+
+/*
+   the size of one block holding the optimal tables and adjacency_matrix
+ */
+static size_t placed_tables_size()
+{
+    long long n_r=number_of_subsets*limit;
+    size_t size=(number_of_subsets+n_r)*sizeof(long long *);
+    for(long long i=0;i<number_of_subsets;i++)
+    {
+        size+=((size_t)1 << subset_size[i])*sizeof(long long);
+    }
+    for(long long v=0;v<n_r;v++)
+    {
+        size+=adjacency_length(v)*sizeof(long long);
+    }
+    return size;
+}
+
+/*
+   Copy the optimal tables and adjacency_matrix into block.
+ */
+static void fill_placed_tables(placed_tables *tables,void *block,size_t size)
+{
+    long long n_r=number_of_subsets*limit;
+    tables->block_size=size;
+    tables->block=block;
+    tables->shared=0;
+    tables->optimal_table=(long long **)tables->block;
+    tables->adjacency_matrix=tables->optimal_table+number_of_subsets;
+
+    long long *p=(long long *)(tables->adjacency_matrix+n_r);
+    for(long long i=0;i<number_of_subsets;i++)
+    {
+        long long length=(long long)1 << subset_size[i];
+        tables->optimal_table[i]=p;
+        memcpy(p,optimal_table[i],length*sizeof(long long));
+        p+=length;
+    }
+    for(long long v=0;v<n_r;v++)
+    {
+        long long length=adjacency_length(v);
+        tables->adjacency_matrix[v]=p;
+        memcpy(p,adjacency_matrix[v],length*sizeof(long long));
+        p+=length;
+    }
+}
+
+/*
+   Copy the optimal tables and adjacency_matrix into one block
+   allocated for the given node.
+ */
+static void copy_to_placed_tables(placed_tables *tables,long long node)
+{
+    size_t size=placed_tables_size();
+    fill_placed_tables(tables,numa_alloc_placed(size,node),size);
+}
+
+static void free_unplaced_tables()
+{
+    free_optimal_table(optimal_table);
+    {
+        long long n_r=reconstructed_graph->n;
+        for(long long i=0; i<n_r; i++)
+        {
+            free(adjacency_matrix[i]);
+        }
+    }
+    free(adjacency_matrix);
+}
+
+/*
+   Copy the precomputed structures to the replicas in shared memory,
+   which the solver processes forked later map read-only.  The pages are
+   placed before they are first touched.
+ */
+static void share_precomputed_tables()
+{
+    size_t size=placed_tables_size();
+    for(long long node=0;node<number_of_replicas;node++)
+    {
+        void *block=map_shared_memory(size);
+        numa_place_shared(block,size,node);
+        fill_placed_tables(&replica[node],block,size);
+        mprotect(block,size,PROT_READ);
+        replica[node].shared=1;
+    }
+}
+
+/*
+   Move the precomputed structures to their NUMA placement.
+   With the replicated placement every node gets its own copy;
+   the interleaved placement has a single copy spread over all nodes.
+   Each search thread reads the copy of its node.  With several solver
+   processes the copies are in shared memory.
+ */
+static void place_precomputed_tables()
+{
+    numa_placement_mode mode=get_numa_placement();
+    if(mode == NUMA_PLACEMENT_DEFAULT && number_of_processes == 1)
+    {
+        number_of_replicas=1;
+        replica=(placed_tables *)malloc(sizeof(placed_tables));
+        replica[0].optimal_table=optimal_table;
+        replica[0].adjacency_matrix=adjacency_matrix;
+        replica[0].block=NULL;
+        return;
+    }
+    number_of_replicas = mode == NUMA_PLACEMENT_REPLICATE ? numa_number_of_nodes() : 1;
+    replica=(placed_tables *)malloc(sizeof(placed_tables)*number_of_replicas);
+    if(number_of_processes > 1)
+    {
+        /* the processes pin their threads once they are forked */
+        share_precomputed_tables();
+    }
+    else
+    {
+        numa_pin_worker(0);
+        for(long long node=0;node<number_of_replicas;node++)
+        {
+            copy_to_placed_tables(&replica[node],node);
+        }
+    }
+    free_unplaced_tables();
+    if(mode != NUMA_PLACEMENT_DEFAULT)
+    {
+        printf("NUMA placement = %s (%lld nodes, %lld copies)\n",
+                numa_placement_name(mode), numa_number_of_nodes(), number_of_replicas);
+    }
+}
+
+static void free_precomputed_tables()
+{
+    free(table_offset);
+    table_offset=NULL;
+    if(replica[0].block == NULL)
+    {
+        free_unplaced_tables();
+        free(replica);
+        replica=NULL;
+        return;
+    }
+    for(long long node=0;node<number_of_replicas;node++)
+    {
+        if(replica[node].shared)
+        {
+            unmap_shared_memory(replica[node].block,replica[node].block_size);
+            continue;
+        }
+        numa_free_placed(replica[node].block,replica[node].block_size);
+    }
+    free(replica);
+    replica=NULL;
+}
+
+/*
+   the weight a clique must beat to be searched for by ctx
+ */
+static inline __attribute__((always_inline)) long long incumbent_weight(search_context *ctx)
+{
+    return atomic_load_explicit(ctx->incumbent,memory_order_relaxed);
+}
+
+/*
+   <return>
+    the weight a bound of the optimal tables or of a coloring must exceed
+    for its branch to be searched: record raised by the gap
+ */
+static inline __attribute__((always_inline)) long long with_gap(long long record)
+{
+    return gap > 0 ? record+(long long)(record*gap) : record;
+}
+
+static inline __attribute__((always_inline)) long long gap_record(search_context *ctx)
+{
+    return with_gap(incumbent_weight(ctx));
+}
+
+/*
+   <return>
+    c[v]; a relaxed atomic load, since the speculative c[] phase commits
+    c[] while the other threads search
+ */
+static inline __attribute__((always_inline)) long long c_of(long long v)
+{
+    return __atomic_load_n(&c[v],__ATOMIC_RELAXED);
+}
+
+/*
+   hand a clique, in the vertex numbers of the input graph, to the
+   record listener
+ */
+static void notify_listener(const long long *clique,long long size,long long clique_weight)
+{
+    long long *vertices=(long long *)malloc(sizeof(long long)*size);
+    for(long long i=0;i<size;i++)
+    {
+        vertices[i]=seq[clique[i]];
+    }
+    listener(vertices,size,clique_weight);
+    free(vertices);
+}
+
+/*
+   Publish the current clique of ctx if it beats the record.
+   The weight is raised with a compare-and-swap, and the winner keeps
+   the clique in its own record, so no lock is taken.
+   A record listener sees the clique before its weight is published.
+   A private incumbent of ctx is raised as well.
+   While ctx is deferred, the clique only goes to its own record, and
+   commit_round() publishes it.
+ */
+static void update_record(search_context *ctx)
+{
+    if(ctx->current_weight > ctx->found_weight)
+    {
+        ctx->found_weight=ctx->current_weight;
+    }
+    if(ctx->incumbent != record_weight && ctx->current_weight > incumbent_weight(ctx))
+    {
+        atomic_store_explicit(ctx->incumbent,ctx->current_weight,memory_order_relaxed);
+    }
+    if(ctx->deferred)
+    {
+        if(ctx->current_weight > ctx->record_weight)
+        {
+            memcpy(ctx->record,ctx->current,sizeof(long long)*ctx->current_size);
+            ctx->record_size=ctx->current_size;
+            ctx->record_weight=ctx->current_weight;
+        }
+        return;
+    }
+    long long best=atomic_load_explicit(record_weight,memory_order_relaxed);
+    if(listener != NULL && ctx->current_weight > best)
+    {
+        notify_listener(ctx->current,ctx->current_size,ctx->current_weight);
+    }
+    if(process_record != NULL && ctx->current_weight > best)
+    {
+        offer_shared_clique(process_record,ctx->current,ctx->current_size,ctx->current_weight);
+    }
+    while(ctx->current_weight > best)
+    {
+        if(atomic_compare_exchange_weak_explicit(record_weight,&best,ctx->current_weight,
+                    memory_order_relaxed,memory_order_relaxed))
+        {
+            memcpy(ctx->record,ctx->current,sizeof(long long)*ctx->current_size);
+            ctx->record_size=ctx->current_size;
+            ctx->record_weight=ctx->current_weight;
+            if(target_weight > 0 && ctx->current_weight >= target_weight)
+            {
+                atomic_store_explicit(&target_reached,true,memory_order_release);
+            }
+            return;
+        }
+    }
+}
+
+/*
+   Take the next branch of a shared frame, in the order expand() would take it.
+   On success the branch vertex is added to the prefix of the frame in
+   ctx->current, and its candidate set is stored to the arena of ctx.
+   <args>
+    ctx: the search thread
+    frame: a shared frame
+    set2_size, new_upper: size and upper bound of the candidate set
+    idle: nonzero if ctx is counted as idle; it becomes busy with the branch
+   <return>
+    the vertex of the branch, or -1 when no branch is left
+ */
+static long long take_branch(search_context *ctx,shared_frame *frame,long long *set2_size,long long *new_upper,long long *idle)
+{
+    long long vertex=-1;
+    pthread_mutex_lock(&frame->lock);
+    while(!frame->exhausted)
+    {
+        long long *set=frame->set;
+        long long i=highest_live_word(set,live_words(set),frame->i,use_summaries);
+        frame->i=i;
+        if(i < 0 || search_stopped())
+        {
+            frame->exhausted=1;
+            break;
+        }
+        long long record=incumbent_weight(ctx);
+        /* check upper bound of optimal tables */
+        if(frame->current_weight + frame->upper <= with_gap(record))
+        {
+            frame->exhausted=1;
+            break;
+        }
+        long long msb=msb_of(set[i]);
+        vertex = (i*limit) + msb;
+        /* check upper bound of c[]*/
+        if(frame->current_weight + c_of(vertex) <= record)
+        {
+            ++ctx->c_prunes;
+            frame->exhausted=1;
+            vertex=-1;
+            break;
+        }
+        long long bit=branch_bit(ctx,set,i,msb,limit,use_summaries);
+        vertex = (i*limit) + bit;
+        long long **optimal_table = ctx->optimal_table;
+        /* every process deletes the same branches in the same order */
+        long long skipped=frame->sliced && frame->branch_index++ % number_of_processes != process_index;
+        if(!skipped)
+        {
+            /* make new set */
+            *set2_size = word_count[vertex];
+            long long *adjv = ctx->adjacency_matrix[vertex];
+            long long *set2 = arena_level(ctx,frame->current_size+1);
+            *new_upper=intersect_candidates(set,adjv,*set2_size,set2,optimal_table,use_summaries);
+            if(bit != msb)
+            {
+                *new_upper+=complete_word(set,i,vertex,set2,set2_size,optimal_table,use_summaries);
+            }
+        }
+        /* delete vertex from set */
+        frame->upper-=optimal_table[i][set[i]];
+        delete_candidate(set,live_words(set),i,bit,use_summaries);
+        frame->upper+=optimal_table[i][set[i]];
+        if(frame->current_size <= dominance_depth)
+        {
+            frame->upper+=delete_dominated(ctx,set,i,vertex,use_summaries);
+        }
+        if(skipped)
+        {
+            /* the branch of another process */
+            vertex=-1;
+            continue;
+        }
+        if(frame->current_size == 0)
+        {
+            ctx->root_word=i;
+        }
+
+        memcpy(ctx->current,frame->current,sizeof(long long)*frame->current_size);
+        ctx->current[frame->current_size] = vertex;
+        ctx->current_size = frame->current_size+1;
+        ctx->current_weight = frame->current_weight + weight[vertex];
+        if(*idle)
+        {
+            atomic_fetch_add(&busy_threads,1);
+            *idle=0;
+        }
+        break;
+    }
+    if(frame->exhausted)
+    {
+        atomic_store_explicit(&frame->steal_depth,LLONG_MAX,memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&frame->lock);
+    return vertex;
+}
+
+/*
+   Search one branch of a shared frame.
+   <return>
+    1 if a branch was searched, 0 if the frame has no branch left
+ */
+static long long search_branch(search_context *ctx,shared_frame *frame,long long *idle)
+{
+    long long set2_size;
+    long long new_upper;
+    if(take_branch(ctx,frame,&set2_size,&new_upper,idle) < 0)
+    {
+        return 0;
+    }
+    if(ctx->current_weight + new_upper > gap_record(ctx))
+    {
+        expand(ctx,arena_level(ctx,ctx->current_size),set2_size,new_upper);
+    }
+    return 1;
+}
+
+/*
+   the shallowest frame with branches left over all threads, or NULL
+ */
+static shared_frame *shallowest_frame()
+{
+    shared_frame *shallowest=NULL;
+    long long shallowest_depth=LLONG_MAX;
+    for(long long t=0;t<number_of_threads;t++)
+    {
+        search_context *victim=&contexts[t];
+        long long top=atomic_load_explicit(&victim->frames_top,memory_order_acquire);
+        for(long long k=0;k<top;k++)
+        {
+            long long depth=atomic_load_explicit(&victim->frames[k].steal_depth,memory_order_relaxed);
+            if(depth != LLONG_MAX)
+            {
+                if(depth < shallowest_depth)
+                {
+                    shallowest=&victim->frames[k];
+                    shallowest_depth=depth;
+                }
+                break;
+            }
+        }
+    }
+    return shallowest;
+}
+
+/*
+   Search the root frame, then steal the shallowest unexplored branches
+   of the other threads until every thread is idle.
+ */
+static void search_in_parallel(search_context *ctx,shared_frame *root)
+{
+    long long idle=0;
+    while(search_branch(ctx,root,&idle));
+    for(;;)
+    {
+        unsigned long long pushed=atomic_load(&frames_pushed);
+        shared_frame *frame=shallowest_frame();
+        if(frame != NULL && search_branch(ctx,frame,&idle))
+        {
+            continue;
+        }
+        if(!idle)
+        {
+            /* look once more after going idle: a push that saw this
+               thread busy did not signal */
+            idle=1;
+            if(atomic_fetch_sub(&busy_threads,1) == 1)
+            {
+                pthread_mutex_lock(&idle_lock);
+                pthread_cond_broadcast(&work_changed);
+                pthread_mutex_unlock(&idle_lock);
+            }
+            continue;
+        }
+        pthread_mutex_lock(&idle_lock);
+        while(atomic_load(&frames_pushed) == pushed && atomic_load(&busy_threads) != 0)
+        {
+            pthread_cond_wait(&work_changed,&idle_lock);
+        }
+        pthread_mutex_unlock(&idle_lock);
+        if(atomic_load(&busy_threads) == 0)
+        {
+            break;
+        }
+    }
+}
+
+/*
+   Wake the idle threads after a frame has been pushed.
+ */
+static void announce_frame()
+{
+    atomic_fetch_add(&frames_pushed,1);
+    if(atomic_load(&busy_threads) < number_of_threads)
+    {
+        pthread_mutex_lock(&idle_lock);
+        pthread_cond_broadcast(&work_changed);
+        pthread_mutex_unlock(&idle_lock);
+    }
+}
+
+/*
+   Publish the heaviest record of the round, of the thread with the
+   smallest index among equals; it becomes the record of the next round.
+ */
+static void commit_round()
+{
+    search_context *best=NULL;
+    for(long long t=0;t<number_of_threads;t++)
+    {
+        if(contexts[t].record_weight > committed_record
+                && (best == NULL || contexts[t].record_weight > best->record_weight))
+        {
+            best=&contexts[t];
+        }
+    }
+    number_of_rounds++;
+    if(best == NULL)
+    {
+        return;
+    }
+    long long published=atomic_load_explicit(record_weight,memory_order_relaxed);
+    if(listener != NULL && best->record_weight > published)
+    {
+        notify_listener(best->record,best->record_size,best->record_weight);
+    }
+    if(process_record != NULL && best->record_weight > published)
+    {
+        offer_shared_clique(process_record,best->record,best->record_size,best->record_weight);
+    }
+    while(best->record_weight > published
+            && !atomic_compare_exchange_weak_explicit(record_weight,&published,best->record_weight,
+                memory_order_relaxed,memory_order_relaxed));
+    committed_record=best->record_weight;
+    if(target_weight > 0 && committed_record >= target_weight)
+    {
+        atomic_store_explicit(&target_reached,true,memory_order_release);
+    }
+}
+
+/*
+   Search a root frame in rounds with a fixed decomposition: in every
+   round thread t takes the t-th branch, in the order of the threads,
+   and all threads search against the record committed at the end of the
+   previous round and their own records of this round.  The search of a
+   thread depends only on its branches and these records, so the numbers
+   of recursive calls and the clique are the same in every run.
+ */
+static void search_deterministically(search_context *ctx,shared_frame *root)
+{
+    ctx->incumbent=&ctx->private_incumbent;
+    ctx->deferred=1;
+    for(;;)
+    {
+        pthread_barrier_wait(&round_barrier);
+        if(last_round)
+        {
+            break;
+        }
+        atomic_store_explicit(&ctx->private_incumbent,committed_record,memory_order_relaxed);
+
+        pthread_mutex_lock(&turn_lock);
+        while(turn != ctx->worker)
+        {
+            pthread_cond_wait(&turn_changed,&turn_lock);
+        }
+        pthread_mutex_unlock(&turn_lock);
+        long long idle=0;
+        long long set2_size;
+        long long new_upper;
+        long long vertex=take_branch(ctx,root,&set2_size,&new_upper,&idle);
+        pthread_mutex_lock(&turn_lock);
+        turn=(turn+1)%number_of_threads;
+        pthread_cond_broadcast(&turn_changed);
+        pthread_mutex_unlock(&turn_lock);
+
+        if(vertex >= 0 && ctx->current_weight + new_upper > gap_record(ctx))
+        {
+            expand(ctx,arena_level(ctx,ctx->current_size),set2_size,new_upper);
+        }
+        if(pthread_barrier_wait(&round_barrier) == PTHREAD_BARRIER_SERIAL_THREAD)
+        {
+            commit_round();
+            last_round=root->exhausted;
+        }
+    }
+    ctx->deferred=0;
+    ctx->incumbent=record_weight;
+}
+
+/*
+   the number of a search thread among the threads of all processes,
+   by which it is pinned and reads a replica
+ */
+static long long placement_worker(long long worker)
+{
+    return process_index*number_of_threads+worker;
+}
+
+static void *search_worker(void *arg)
+{
+    search_context *ctx=(search_context *)arg;
+    numa_pin_worker(placement_worker(ctx->worker));
+    for(;;)
+    {
+        pthread_barrier_wait(&frame_start);
+        if(speculating)
+        {
+            speculate_prefixes(ctx);
+            pthread_barrier_wait(&frame_finish);
+            continue;
+        }
+        if(active_frame == NULL)
+        {
+            break;
+        }
+        if(deterministic)
+        {
+            search_deterministically(ctx,active_frame);
+        }
+        else
+        {
+            search_in_parallel(ctx,active_frame);
+        }
+        pthread_barrier_wait(&frame_finish);
+    }
+    return NULL;
+}
+
+/*
+   Search a root node with all threads; it counts as one call of expand().
+   Small candidate sets are not worth waking the workers for.
+ */
+static void search_frame(shared_frame *frame)
+{
+    search_context *ctx=&contexts[0];
+    ++ctx->branch_count;
+    if (ctx->branch_count % 100000 == 0)
+        check_for_stop();
+    if (search_stopped())
+        return;
+    if(lookahead_depth > 0)
+    {
+        ctx->current_size=frame->current_size;
+        ctx->current_weight=frame->current_weight;
+        if(!lookahead_may_beat_record(ctx,frame->set,frame->set_size,frame->upper))
+        {
+            return;
+        }
+    }
+
+    frame->i=frame->set_size-1;
+    frame->exhausted=0;
+    frame->sliced=number_of_processes > 1;
+    frame->branch_index=0;
+    long long candidates=0;
+    for(long long j=0;j<frame->set_size;j++)
+    {
+        candidates+=__builtin_popcountll(frame->set[j]);
+    }
+    if(number_of_threads == 1 || candidates < PARALLEL_MIN_CANDIDATES)
+    {
+        long long idle=0;
+        if(interleaved_lanes > 1)
+        {
+            search_interleaved(frame);
+        }
+        else
+        {
+            while(search_branch(ctx,frame,&idle));
+        }
+    }
+    else
+    {
+        active_frame=frame;
+        if(deterministic)
+        {
+            turn=0;
+            last_round=0;
+            committed_record=atomic_load(record_weight);
+            pthread_barrier_wait(&frame_start);
+            search_deterministically(ctx,frame);
+            pthread_barrier_wait(&frame_finish);
+        }
+        else
+        {
+            sharing=1;
+            atomic_store(&busy_threads,number_of_threads);
+            pthread_barrier_wait(&frame_start);
+            search_in_parallel(ctx,frame);
+            pthread_barrier_wait(&frame_finish);
+            sharing=0;
+        }
+    }
+
+    memcpy(ctx->current,frame->current,sizeof(long long)*frame->current_size);
+    ctx->current_size=frame->current_size;
+    ctx->current_weight=frame->current_weight;
+    update_record(ctx);
+}
+
+static void init_shared_frame(shared_frame *frame,long long current_length)
+{
+    frame->set=(long long *)malloc(sizeof(long long)*set_length);
+    frame->current=(long long *)malloc(sizeof(long long)*current_length);
+    frame->exhausted=1;
+    frame->sliced=0;
+    atomic_init(&frame->steal_depth,LLONG_MAX);
+    pthread_mutex_init(&frame->lock,NULL);
+}
+
+static void destroy_shared_frame(shared_frame *frame)
+{
+    free(frame->set);
+    free(frame->current);
+    pthread_mutex_destroy(&frame->lock);
+}
+
+/*
+   a bound of the number of vertices of a clique: the maximum degree plus one
+ */
+static long long clique_size_bound()
+{
+    long long n=input_graph->n;
+    long long bound=0;
+    for(long long i=0;i<n;i++)
+    {
+        long long degree=count_nonzero(input_graph->adjacency_matrix[i],n);
+        if(degree+1 > bound)
+        {
+            bound=degree+1;
+        }
+    }
+    return bound;
+}
+
+static void start_search_threads()
+{
+    long long n=input_graph->n;
+    long long arena_levels=clique_size_bound()+1;
+    if(number_of_processes > 1)
+    {
+        /* the tables were placed before the processes were forked */
+        numa_pin_worker(placement_worker(0));
+    }
+    number_of_contexts=number_of_threads + (interleaved_lanes > 1 ? interleaved_lanes : 0);
+    contexts=(search_context *)calloc(number_of_contexts,sizeof(search_context));
+    for(long long t=0;t<number_of_contexts;t++)
+    {
+        search_context *ctx=&contexts[t];
+        /* the lanes run on thread 0 */
+        long long worker = t < number_of_threads ? t : 0;
+        placed_tables *tables=&replica[numa_node_of_worker(placement_worker(worker)) % number_of_replicas];
+        ctx->worker=worker;
+        ctx->optimal_table=tables->optimal_table;
+        ctx->adjacency_matrix=tables->adjacency_matrix;
+        ctx->record=(long long *)malloc(sizeof(long long)*n);
+        ctx->current=(long long *)malloc(sizeof(long long)*n);
+        ctx->arena=(long long *)malloc(sizeof(long long)*set_length*arena_levels);
+        ctx->stack=(expand_frame *)malloc(sizeof(expand_frame)*arena_levels);
+        ctx->outsiders=(long long *)malloc(sizeof(long long)*2*number_of_subsets);
+        ctx->lookahead=(long long *)malloc(sizeof(long long)*2*number_of_subsets);
+        ctx->lookahead_limit=1;
+        ctx->root_word=-1;
+        ctx->incumbent=record_weight;
+        ctx->repartition_mean_calls=-1;
+        if(repartition_depth > 0)
+        {
+            alloc_local_partition(ctx);
+        }
+        atomic_init(&ctx->frames_top,0);
+        if(number_of_threads > 1 && t < number_of_threads)
+        {
+            ctx->frames=(shared_frame *)malloc(sizeof(shared_frame)*MAX_SHARED_FRAMES);
+            for(long long k=0;k<MAX_SHARED_FRAMES;k++)
+            {
+                init_shared_frame(&ctx->frames[k],MAX_SHARED_FRAMES);
+            }
+        }
+    }
+    lanes=(search_lane *)calloc(interleaved_lanes,sizeof(search_lane));
+    for(long long k=0;k<interleaved_lanes && interleaved_lanes > 1;k++)
+    {
+        lanes[k].ctx=&contexts[number_of_threads+k];
+    }
+    if(number_of_threads == 1)
+    {
+        return;
+    }
+    pthread_barrier_init(&frame_start,NULL,number_of_threads);
+    pthread_barrier_init(&frame_finish,NULL,number_of_threads);
+    pthread_barrier_init(&round_barrier,NULL,number_of_threads);
+    pthread_mutex_init(&turn_lock,NULL);
+    pthread_cond_init(&turn_changed,NULL);
+    pthread_mutex_init(&idle_lock,NULL);
+    pthread_cond_init(&work_changed,NULL);
+    number_of_rounds=0;
+    worker_threads=(pthread_t *)malloc(sizeof(pthread_t)*number_of_threads);
+    for(long long t=1;t<number_of_threads;t++)
+    {
+        pthread_create(&worker_threads[t],NULL,search_worker,&contexts[t]);
+    }
+}
+
+static void stop_search_threads()
+{
+    if(number_of_threads > 1)
+    {
+        active_frame=NULL;
+        pthread_barrier_wait(&frame_start);
+        for(long long t=1;t<number_of_threads;t++)
+        {
+            pthread_join(worker_threads[t],NULL);
+        }
+        free(worker_threads);
+        pthread_barrier_destroy(&frame_start);
+        pthread_barrier_destroy(&frame_finish);
+        pthread_barrier_destroy(&round_barrier);
+        pthread_mutex_destroy(&turn_lock);
+        pthread_cond_destroy(&turn_changed);
+        pthread_mutex_destroy(&idle_lock);
+        pthread_cond_destroy(&work_changed);
+    }
+    for(long long t=0;t<number_of_contexts;t++)
+    {
+        if(number_of_threads > 1 && t < number_of_threads)
+        {
+            for(long long k=0;k<MAX_SHARED_FRAMES;k++)
+            {
+                destroy_shared_frame(&contexts[t].frames[k]);
+            }
+            free(contexts[t].frames);
+        }
+        free(contexts[t].current);
+        free(contexts[t].arena);
+        free(contexts[t].stack);
+        free(contexts[t].outsiders);
+        free(contexts[t].lookahead);
+        free_local_partition(&contexts[t]);
+    }
+    free(lanes);
+}
+
+/*
+   word_neighbours[v] has bit b if v and the vertex of bit b of its
+   subset are adjacent, in either order of the vertex sequence
+ */
+static void find_word_neighbours()
+{
+    long long n_r=number_of_subsets*limit;
+    long long **adjacency_matrix=contexts[0].adjacency_matrix;
+    word_neighbours = (long long *)calloc(n_r,sizeof(long long));
+    for(long long v=1;v<n_r;v++)
+    {
+        long long i=v/limit;
+        long long b=v%limit;
+        if(b == 0)
+        {
+            continue;
+        }
+        long long earlier=adjacency_matrix[v][i] & ((1LL<<b)-1);
+        word_neighbours[v] |= earlier;
+        for(long long m=earlier;m != 0;m &= m-1)
+        {
+            word_neighbours[i*limit+__builtin_ctzll(m)] |= 1LL<<b;
+        }
+    }
+}
+
+/*
+   Solve the prefix problem of v: the cliques of v and earlier vertices
+   which contain v and beat the incumbent of ctx.
+   c[] of the prefixes not yet committed is only bounded, which weakens
+   the search but not its result.
+ */
+static void solve_prefix(search_context *ctx,long long v)
+{
+    long long i=v/limit;
+    long long *adjv=ctx->adjacency_matrix[v];
+    long long *set2=arena_level(ctx,1);
+    long long upper=0;
+    set2[i]=0;
+    for(long long k=0;k<word_count[v];k++)
+    {
+        set2[k]=adjv[k] & ((1LL<<subset_size[k])-1);
+        upper+=ctx->optimal_table[k][set2[k]];
+    }
+    summarize_set(set2,i+1);
+    ctx->current[0]=v;
+    ctx->current_size=1;
+    ctx->current_weight=weight[v];
+    ctx->found_weight=0;
+    if(ctx->current_weight + upper > gap_record(ctx))
+    {
+        expand(ctx,set2,i+1,upper);
+    }
+}
+
+/*
+   Until prefix l is committed, c[] of its vertex is bounded by c[] of
+   the previous prefix plus the weight of the vertex, so that the later
+   prefixes solved meanwhile are not left without c[].
+   The caller holds prefixes.lock.
+ */
+static void bound_prefix(long long l)
+{
+    long long v=prefixes.vertex[l];
+    long long previous = l == 0 ? 0 : c_of(prefixes.vertex[l-1]);
+    __atomic_store_n(&c[v],previous+weight[v],__ATOMIC_RELAXED);
+}
+
+/*
+   Record the cost of the prefix problems solved so far and, in the
+   adaptive mode, decide whether c[] ends here.  The prefixes of the last
+   window are projected over the remaining vertices; the phase ends when
+   this exceeds the cost of all prefixes so far, scaled by how often the
+   c[] of the window prunes per call relative to all c[] so far.  The
+   final search of the whole graph then takes the remaining vertices.
+   <args>
+    l: the number of prefixes solved
+   <return>
+    nonzero if the c[] phase ends before prefix l
+ */
+static long long end_c_phase(long long l)
+{
+    unsigned long calls=0;
+    unsigned long prunes=0;
+    for(long long t=0;t<number_of_contexts;t++)
+    {
+        calls+=contexts[t].branch_count;
+        prunes+=contexts[t].c_prunes;
+    }
+    c_phase.calls[l]=calls;
+    c_phase.prunes[l]=prunes;
+    long long n=c_phase.number_of_vertices;
+    long long window=n*C_STOP_WINDOW;
+    if(window < C_STOP_MIN_WINDOW)
+    {
+        window=C_STOP_MIN_WINDOW;
+    }
+    if(!adaptive_stop() || l < n*C_STOP_MIN_FRACTION || l < window)
+    {
+        return 0;
+    }
+    double window_calls=calls-c_phase.calls[l-window];
+    double window_prunes=prunes-c_phase.prunes[l-window];
+    if(window_calls == 0 || prunes == 0)
+    {
+        return 0;
+    }
+    if(window_prunes < 1)
+    {
+        window_prunes=1;
+    }
+    double projected=window_calls/window*(n-l);
+    double discounted=(double)calls*(window_prunes/window_calls)/((double)prunes/calls);
+    if(projected <= discounted)
+    {
+        return 0;
+    }
+    c_phase.projected=projected;
+    c_phase.discounted=discounted;
+    return 1;
+}
+
+/*
+   Commit c[] of the solved prefixes at the frontier; the caller holds
+   prefixes.lock.
+   A prefix solved against the record of the whole graph gives c[] of the
+   serial phase only if the record is explained by the earlier prefixes
+   or by its own cliques.  Otherwise the record came from a later prefix
+   and may hide cliques of this prefix, so the prefix is solved again
+   against a private incumbent, the value c[] would have in the serial
+   phase if the prefix held no heavier clique.
+ */
+static void commit_prefixes(search_context *ctx)
+{
+    while(prefixes.committed < prefixes.number_of_prefixes && prefixes.solved[prefixes.committed])
+    {
+        if(search_stopped())
+        {
+            return;
+        }
+        long long l=prefixes.committed;
+        long long previous = l == 0 ? 0 : c_of(prefixes.vertex[l-1]);
+        long long exact = prefixes.found[l] > previous ? prefixes.found[l] : previous;
+        if(prefixes.incumbent[l] > exact)
+        {
+            prefixes.solved[l]=0;
+            prefixes.solved_again++;
+            pthread_mutex_unlock(&prefixes.lock);
+            atomic_store_explicit(&ctx->private_incumbent,exact,memory_order_relaxed);
+            ctx->incumbent=&ctx->private_incumbent;
+            solve_prefix(ctx,prefixes.vertex[l]);
+            ctx->incumbent=record_weight;
+            pthread_mutex_lock(&prefixes.lock);
+            if(ctx->found_weight > prefixes.found[l])
+            {
+                prefixes.found[l]=ctx->found_weight;
+            }
+            prefixes.incumbent[l]=atomic_load_explicit(&ctx->private_incumbent,memory_order_relaxed);
+            prefixes.solved[l]=1;
+            continue;
+        }
+        /* the kernels of the other threads read c[] meanwhile */
+        __atomic_store_n(&c[prefixes.vertex[l]],exact,__ATOMIC_RELAXED);
+        prefixes.committed++;
+        if(end_c_phase(prefixes.committed))
+        {
+            /* the claimed prefixes beyond are finished but never committed */
+            prefixes.number_of_prefixes=prefixes.committed;
+        }
+        for(long long k=prefixes.committed;k<prefixes.next;k++)
+        {
+            bound_prefix(k);
+        }
+    }
+}
+
+/*
+   Solve the claimed prefixes one after another, each against the record
+   of the whole graph, until none is left.
+ */
+static void speculate_prefixes(search_context *ctx)
+{
+    for(;;)
+    {
+        pthread_mutex_lock(&prefixes.lock);
+        long long l=prefixes.next;
+        if(l >= prefixes.number_of_prefixes || search_stopped())
+        {
+            pthread_mutex_unlock(&prefixes.lock);
+            return;
+        }
+        prefixes.next++;
+        bound_prefix(l);
+        pthread_mutex_unlock(&prefixes.lock);
+        solve_prefix(ctx,prefixes.vertex[l]);
+        pthread_mutex_lock(&prefixes.lock);
+        prefixes.found[l]=ctx->found_weight;
+        prefixes.incumbent[l]=incumbent_weight(ctx);
+        prefixes.solved[l]=1;
+        commit_prefixes(ctx);
+        pthread_mutex_unlock(&prefixes.lock);
+    }
+}
+
+/*
+   Compute c[] of the first number_of_prefixes vertices of the sequence
+   with all threads, which solve the prefix problems speculatively.
+ */
+static void compute_c_speculatively(long long number_of_prefixes)
+{
+    prefixes.number_of_prefixes=number_of_prefixes;
+    prefixes.vertex=(long long *)malloc(sizeof(long long)*number_of_prefixes);
+    prefixes.found=(long long *)malloc(sizeof(long long)*number_of_prefixes);
+    prefixes.incumbent=(long long *)malloc(sizeof(long long)*number_of_prefixes);
+    prefixes.solved=(long long *)calloc(number_of_prefixes,sizeof(long long));
+    prefixes.next=0;
+    prefixes.committed=0;
+    prefixes.solved_again=0;
+    pthread_mutex_init(&prefixes.lock,NULL);
+    for(long long i=0,l=0;i<number_of_subsets && l<number_of_prefixes;i++)
+    {
+        for(long long j=0;j<subset_size[i] && l<number_of_prefixes;j++)
+        {
+            prefixes.vertex[l++]=i*limit+j;
+        }
+    }
+
+    speculating=1;
+    pthread_barrier_wait(&frame_start);
+    speculate_prefixes(&contexts[0]);
+    pthread_barrier_wait(&frame_finish);
+    speculating=0;
+
+    pthread_mutex_destroy(&prefixes.lock);
+    free(prefixes.vertex);
+    free(prefixes.found);
+    free(prefixes.incumbent);
+    free(prefixes.solved);
+}
+
+/*
+   nonzero if the end of the c[] phase is chosen while it runs,
+   which the solver processes could not agree on
+ */
+static long long adaptive_stop()
+{
+    return adaptive_c_stop && number_of_processes == 1;
+}
+
+/*
+   nonzero if the threads solve the prefix problems of c[] speculatively
+ */
+static long long speculates_c()
+{
+    return speculative_c && number_of_threads > 1 && !deterministic && number_of_processes == 1;
+}
+
+/*
+   Fork the solver processes 1 to number_of_processes-1, which share the
+   read-only tables, the record weight and the best clique with this
+   process.  Each process returns from here with its own process_index.
+ */
+static void fork_processes()
+{
+    group_size=sizeof(process_group)+sizeof(_Atomic long long)*(input_graph->n+1);
+    group=(process_group *)map_shared_memory(group_size);
+    group->coordinator=getpid();
+    pthread_mutexattr_t mutex_attributes;
+    pthread_mutexattr_init(&mutex_attributes);
+    pthread_mutexattr_setpshared(&mutex_attributes,PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mutex_attributes,PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&group->lock,&mutex_attributes);
+    pthread_mutexattr_destroy(&mutex_attributes);
+    pthread_condattr_t cond_attributes;
+    pthread_condattr_init(&cond_attributes);
+    pthread_condattr_setpshared(&cond_attributes,PTHREAD_PROCESS_SHARED);
+    pthread_condattr_setclock(&cond_attributes,CLOCK_MONOTONIC);
+    pthread_cond_init(&group->done_changed,&cond_attributes);
+    pthread_condattr_destroy(&cond_attributes);
+    group->slot[0].pid=getpid();
+    process_record=create_shared_record(input_graph->n);
+    if(record_weight == &own_record_weight)
+    {
+        record_weight=shared_record_weight(process_record);
+        atomic_store(record_weight,get_initial_record());
+    }
+    fflush(stdout);
+    for(long long p=1;p<number_of_processes;p++)
+    {
+        pid_t pid=fork();
+        if(pid == 0)
+        {
+            process_index=p;
+            /* a process outliving its coordinator stops */
+            prctl(PR_SET_PDEATHSIG,SIGKILL);
+            if(getppid() != group->coordinator)
+            {
+                _exit(1);
+            }
+            return;
+        }
+        if(pid < 0)
+        {
+            perror("fork");
+            exit(1);
+        }
+        group->slot[p].pid=pid;
+    }
+}
+
+/*
+   Reap the processes that have exited.  A process that exits before its
+   search is over stops the search of all processes, as the time limit does.
+ */
+static void watch_processes(long long block)
+{
+    for(long long p=1;p<number_of_processes;p++)
+    {
+        process_slot *slot=&group->slot[p];
+        int status;
+        if(slot->reaped || waitpid(slot->pid,&status,block ? 0 : WNOHANG) <= 0)
+        {
+            continue;
+        }
+        slot->reaped=1;
+        if(!slot->finished || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            slot->finished=0;
+            atomic_store(&group->failed,1);
+        }
+    }
+}
+
+/*
+   Lock the memory of the processes, which a process may have died holding.
+ */
+static void lock_group()
+{
+    if(pthread_mutex_lock(&group->lock) == EOWNERDEAD)
+    {
+        pthread_mutex_consistent(&group->lock);
+    }
+}
+
+/*
+   Wait until every process has solved its slice of prefix l, after which
+   the record weight is c[] of the prefix.
+ */
+static void wait_for_processes(long long l)
+{
+    lock_group();
+    atomic_fetch_add(&group->done[l],1);
+    pthread_cond_broadcast(&group->done_changed);
+    while(atomic_load(&group->done[l]) < number_of_processes)
+    {
+        if(atomic_load(&group->failed))
+        {
+            pthread_mutex_unlock(&group->lock);
+            set_timeout_flag();
+            return;
+        }
+        if(process_index == 0)
+        {
+            watch_processes(0);
+        }
+        /* a process that dies does not signal; wake now and then to see it */
+        struct timespec wake;
+        clock_gettime(CLOCK_MONOTONIC,&wake);
+        wake.tv_nsec+=PROCESS_WATCH_NANOSECONDS;
+        if(wake.tv_nsec >= 1000000000)
+        {
+            wake.tv_sec++;
+            wake.tv_nsec-=1000000000;
+        }
+        if(pthread_cond_timedwait(&group->done_changed,&group->lock,&wake) == EOWNERDEAD)
+        {
+            pthread_mutex_consistent(&group->lock);
+        }
+    }
+    pthread_mutex_unlock(&group->lock);
+}
+
+/*
+   Leave the search of a process: the processes other than the
+   coordinator store their counts and exit.  The coordinator waits for
+   them, adds their counts to its own and takes the best clique of all.
+ */
+static void finish_processes()
+{
+    process_slot *own=&group->slot[process_index];
+    for(long long t=0;t<number_of_contexts;t++)
+    {
+        own->branch_count+=contexts[t].branch_count;
+        own->c_prunes+=contexts[t].c_prunes;
+    }
+    own->open_bound=open_upper_bound;
+    own->finished=1;
+    if(process_index > 0)
+    {
+        _exit(0);
+    }
+
+    watch_processes(1);
+    if(atomic_load(&group->failed))
+    {
+        set_timeout_flag();
+    }
+    for(long long p=1;p<number_of_processes;p++)
+    {
+        contexts[0].branch_count+=group->slot[p].branch_count;
+        contexts[0].c_prunes+=group->slot[p].c_prunes;
+        if(!group->slot[p].finished)
+        {
+            open_upper_bound=LLONG_MAX;
+        }
+        else if(group->slot[p].open_bound > open_upper_bound && open_upper_bound < LLONG_MAX)
+        {
+            open_upper_bound=group->slot[p].open_bound;
+        }
+    }
+    long long best=0;
+    for(long long t=0;t<number_of_contexts;t++)
+    {
+        if(contexts[t].record_weight > best)
+        {
+            best=contexts[t].record_weight;
+        }
+    }
+    long long shared_weight;
+    long long *vertices=(long long *)malloc(sizeof(long long)*(input_graph->n > 0 ? input_graph->n : 1));
+    long long size=read_shared_clique(process_record,vertices,&shared_weight);
+    if(shared_weight > best)
+    {
+        memcpy(contexts[0].record,vertices,sizeof(long long)*size);
+        contexts[0].record_size=size;
+        contexts[0].record_weight=shared_weight;
+    }
+    free(vertices);
+}
+
+/*
+   Unmap the memory shared by the processes, once the result is taken.
+ */
+static void release_processes()
+{
+    if(record_weight == shared_record_weight(process_record))
+    {
+        record_weight=&own_record_weight;
+    }
+    destroy_shared_record(process_record);
+    process_record=NULL;
+    pthread_mutex_destroy(&group->lock);
+    pthread_cond_destroy(&group->done_changed);
+    unmap_shared_memory(group,group_size);
+    group=NULL;
+}
+
+/*
+   Bound the cliques a stopped search may have missed.  The prefix
+   problems before c_phase.length were solved, so the cliques of their
+   vertices weigh at most the record raised by the gap.  A clique ending
+   at a later vertex v weighs at most weight[v] plus the optimal tables
+   of the vertices before v, or plus c[] of the solved prefixes raised by
+   the gap and the optimal tables of the unsolved vertices before v.
+   The final search took its root branches from the highest word down,
+   so the words above the root branches of all threads and above the
+   untaken ones are done.
+   <args>
+    roots: the candidates the final search left untaken
+   <return>
+    the upper bound of the maximum weight
+ */
+static long long bound_open_branches(long long *roots)
+{
+    long long **optimal_table=contexts[0].optimal_table;
+    long long **adjacency_matrix=contexts[0].adjacency_matrix;
+    long long open_word=-1;
+    for(long long i=number_of_subsets-1;i >= 0 && open_word < 0;i--)
+    {
+        if(roots[i] != 0)
+        {
+            open_word=i;
+        }
+    }
+    for(long long t=0;t<number_of_contexts;t++)
+    {
+        if(contexts[t].root_word > open_word)
+        {
+            open_word=contexts[t].root_word;
+        }
+    }
+    long long bound=with_gap(atomic_load(record_weight));
+    long long l=0;
+    long long solved_weight=0; /* c[] of the last solved prefix */
+    long long unsolved=-1; /* the first vertex of an unsolved prefix */
+    for(long long v=0;v<number_of_subsets*limit && v/limit <= open_word;v++)
+    {
+        long long i=v/limit;
+        if(v%limit >= subset_size[i])
+        {
+            continue;
+        }
+        if(l < c_phase.length)
+        {
+            solved_weight=c[v];
+            ++l;
+            continue;
+        }
+        if(unsolved < 0)
+        {
+            unsolved=v;
+        }
+        long long upper=0;
+        long long tail=with_gap(solved_weight);
+        for(long long k=0;k<adjacency_length(v);k++)
+        {
+            long long set=adjacency_matrix[v][k] & ((1LL << subset_size[k])-1);
+            upper+=optimal_table[k][set];
+            if(k == unsolved/limit)
+            {
+                set&=~((1LL << unsolved%limit)-1);
+            }
+            if(k >= unsolved/limit)
+            {
+                tail+=optimal_table[k][set];
+            }
+        }
+        if(upper > tail)
+        {
+            upper=tail;
+        }
+        if(weight[v]+upper > bound)
+        {
+            bound=weight[v]+upper;
+        }
+    }
+    return bound;
+}
+
+/*
+   Branch-and-bound phase.
+   The root branches of every prefix problem, and of the final search of
+   the whole graph, are shared by the threads, and so are the shallow
+   nodes below them; c[v] is written only after all threads have
+   finished the prefix problem of v.
+   With the speculative c[] phase, each thread solves whole prefix
+   problems instead, ahead of the committed c[].
+ */
+static void branch_and_bound()
+{
+    long long n=input_graph->n;
+
+    /* initialize variables used in branch-and-bound phase */
+    atomic_store(&target_reached,false);
+    if(record_weight == &own_record_weight)
+    {
+        atomic_store(record_weight,get_initial_record());
+    }
+    summary_words=(number_of_subsets+63)/64;
+    set_length=number_of_subsets+summary_words;
+    start_search_threads();
+    c = (long long *)malloc(sizeof(long long) * (number_of_subsets*limit));
+    word_count = (long long *)malloc(sizeof(long long) * (number_of_subsets*limit));
+    for(long long i=0;i<number_of_subsets*limit;i++)
+    {
+        c[i]=LLONG_MAX/2;
+        word_count[i] = i == 0 ? 0 : (i-1)/limit+1;
+    }
+    find_word_neighbours();
+    select_expand_kernel();
+    long long **optimal_table=contexts[0].optimal_table;
+    long long **adjacency_matrix=contexts[0].adjacency_matrix;
+    shared_frame frame;
+    init_shared_frame(&frame,1);
+
+    long long stop=n;
+    if(c_stop_fraction > 0)
+    {
+        stop=n*c_stop_fraction;
+    }
+    else if(weighted && !adaptive_stop())
+    {
+        stop=n*0.8;
+    }
+    c_phase.number_of_vertices=n;
+    c_phase.length=0;
+    c_phase.calls=(unsigned long *)malloc(sizeof(unsigned long)*(n+1));
+    c_phase.prunes=(unsigned long *)malloc(sizeof(unsigned long)*(n+1));
+    c_phase.calls[0]=0;
+    c_phase.prunes[0]=0;
+    c_phase.projected=0;
+    c_phase.discounted=0;
+
+    /* main loop */
+    long long *set = (long long *)calloc(number_of_subsets,sizeof(long long));
+    {
+        long long i=0;long long j=0;long long l=0;
+        if(speculates_c())
+        {
+            compute_c_speculatively(stop);
+            c_phase.length=prefixes.committed;
+            goto nobs;
+        }
+        for(i=0; i<number_of_subsets; i++)
+        {
+            for(;j<subset_size[i];j++)
+            {
+                if(l==stop || end_c_phase(l))
+                {
+                    goto nobs; /* stop calculation of c[] */
+                }
+                l++;
+                set[i] += (1<<j);
+                long long v = (i*limit) + j;
+                long long* adjv=adjacency_matrix[v];
+                long long* set2=frame.set;
+                long long upper=0;
+                set2[i]=0;
+                long long k=(v-1)/limit+1;
+                while(k--)
+                {
+                    set2[k] = set[k] & adjv[k];
+                    upper+=optimal_table[k][set2[k]];
+                }
+                frame.set_size=i+1;
+                summarize_set(set2,frame.set_size);
+                frame.upper=upper;
+                frame.current_size=1;
+                frame.current_weight=weight[v];
+                frame.current[0]=v;
+                if(frame.current_weight + upper > with_gap(atomic_load(record_weight)))
+                {
+                    search_frame(&frame);
+                }
+                if(group != NULL)
+                {
+                    wait_for_processes(l);
+                }
+                c[v] = atomic_load(record_weight);
+                if(c_phase.length == l-1 && !search_stopped())
+                {
+                    /* the prefix problem was solved to the end */
+                    c_phase.length=l;
+                }
+            }
+            j=0;
+        }
+nobs:
+        if(target_weight > 0)
+        {
+            long long record=atomic_load(record_weight);
+            while(record < target_weight-1 && !atomic_compare_exchange_weak(record_weight,&record,target_weight-1));
+        }
+        /*
+           Find the exact solution of the orignial input graph.
+         */
+        for(;i<number_of_subsets; i++)
+        {
+            for(;j<subset_size[i];j++)
+            {
+                set[i] += (1<<j);
+            }
+            j=0;
+        }
+        long long upper=0;
+        for(long long i = 0; i < number_of_subsets; ++i)
+        {
+            upper += optimal_table[i][set[i]];
+        }
+        memcpy(frame.set,set,sizeof(long long)*number_of_subsets);
+        frame.set_size=number_of_subsets;
+        summarize_set(frame.set,frame.set_size);
+        frame.upper=upper;
+        frame.current_size=0;
+        frame.current_weight=0;
+        if(frame.current_weight + upper > with_gap(atomic_load(record_weight)))
+        {
+            search_frame(&frame);
+        }
+    }
+    open_upper_bound = is_timeout_flag_set() ? bound_open_branches(frame.set) : -1;
+
+    destroy_shared_frame(&frame);
+    stop_search_threads();
+    free(set);
+    free(c);
+    free(word_count);
+    free(word_neighbours);
+    free(c_phase.calls);
+    free(c_phase.prunes);
+}
+
+/*
+   A candidate set recolored and partitioned afresh, with optimal tables
+   of its own.  Local vertex first[k]+b is bit b of subset k, and the
+   subsets are filled with whole color classes while they fit.
+ */
+typedef struct local_partition
+{
+    long long size;
+    long long number_of_subsets;
+    long long vertex[REPARTITION_MAX]; /* in the order of the color classes */
+    long long weight[REPARTITION_MAX];
+    long long first[REPARTITION_MAX+1];
+    long long *optimal_table[REPARTITION_MAX];
+    long long sequence[REPARTITION_MAX]; /* the candidates in the vertex sequence */
+    long long local[REPARTITION_MAX]; /* the local vertex of sequence[u] */
+    long long position[REPARTITION_MAX]; /* the position of local vertex u in sequence */
+    long long *position_of; /* the position in sequence of each candidate of the node */
+    unsigned long long neighbours[REPARTITION_MAX][REPARTITION_MAX/64]; /* by position in sequence */
+    long long *adjacency; /* a row of number_of_subsets words per local vertex */
+    long long *tables;
+    long long *arena; /* candidate sets of the recursion, one level per clique size */
+} local_partition;
+
+static void alloc_local_partition(search_context *ctx)
+{
+    local_partition *part=(local_partition *)malloc(sizeof(local_partition));
+    part->adjacency=(long long *)malloc(sizeof(long long)*REPARTITION_MAX*REPARTITION_MAX);
+    part->tables=(long long *)malloc(sizeof(long long)*
+            ((REPARTITION_MAX<<REPARTITION_TABLE_BITS)/REPARTITION_TABLE_BITS+(1<<REPARTITION_TABLE_BITS)));
+    part->arena=(long long *)malloc(sizeof(long long)*(REPARTITION_MAX+REPARTITION_MAX/64)*(REPARTITION_MAX+1));
+    part->position_of=(long long *)malloc(sizeof(long long)*number_of_subsets*limit);
+    ctx->partition=part;
+}
+
+static void free_local_partition(search_context *ctx)
+{
+    if(ctx->partition != NULL)
+    {
+        free(ctx->partition->adjacency);
+        free(ctx->partition->tables);
+        free(ctx->partition->arena);
+        free(ctx->partition->position_of);
+        free(ctx->partition);
+    }
+}
+
+/*
+   c[] of the last candidate in the vertex sequence, which bounds every
+   clique of the candidates
+ */
+static inline long long repartition_doll_bound(const local_partition *part,const unsigned long long *members)
+{
+    for(long long k=(part->size-1)/64;k >= 0;k--)
+    {
+        if(members[k] != 0)
+        {
+            return c_of(part->sequence[64*k+63-__builtin_clzll(members[k])]);
+        }
+    }
+    return 0;
+}
+
+/*
+   Branch-and-bound on a repartitioned candidate set.
+   A level of the arena holds the candidates by subset, then the same
+   candidates by position in the vertex sequence, for c[].
+   Each call counts as one recursive call of expand().
+ */
+static void expand_repartitioned(search_context *ctx,local_partition *part,long long *set,long long set_size,long long upper)
+{
+    ++ctx->branch_count;
+    ++ctx->repartition_calls;
+    if (ctx->branch_count % 100000 == 0)
+        check_for_stop();
+    if (search_stopped())
+        return;
+
+    long long number_of_subsets2=part->number_of_subsets;
+    long long length=(part->size+63)/64;
+    unsigned long long *members=(unsigned long long *)set+number_of_subsets2;
+    long long *set2=set+number_of_subsets2+length;
+    unsigned long long *members2=(unsigned long long *)set2+number_of_subsets2;
+    for(long long i=set_size-1;i >= 0;i--)
+    {
+        while(set[i] != 0)
+        {
+            long long record=incumbent_weight(ctx);
+            if(ctx->current_weight + upper <= with_gap(record)
+                    || ctx->current_weight + repartition_doll_bound(part,members) <= record)
+            {
+                return;
+            }
+            long long bit=msb_of(set[i]);
+            long long u=part->first[i]+bit;
+            long long position=part->position[u];
+            long long *row=part->adjacency+u*number_of_subsets2;
+            long long new_upper=0;
+            long long set2_size=0;
+            for(long long k=0;k <= i;k++)
+            {
+                set2[k]=set[k] & row[k];
+                new_upper+=part->optimal_table[k][set2[k]];
+                if(set2[k] != 0)
+                {
+                    set2_size=k+1;
+                }
+            }
+            for(long long k=0;k<length;k++)
+            {
+                members2[k]=members[k] & part->neighbours[position][k];
+            }
+            ctx->current[ctx->current_size++]=part->vertex[u];
+            ctx->current_weight+=part->weight[u];
+            if(ctx->current_weight + new_upper > with_gap(record))
+            {
+                if(set2_size == 0)
+                {
+                    update_record(ctx);
+                }
+                else
+                {
+                    expand_repartitioned(ctx,part,set2,set2_size,new_upper);
+                }
+            }
+            --ctx->current_size;
+            ctx->current_weight-=part->weight[u];
+            upper-=part->optimal_table[i][set[i]];
+            set[i] &= ~(1LL<<bit);
+            upper+=part->optimal_table[i][set[i]];
+            members[position>>6] &= ~(1ULL<<(position&63));
+        }
+    }
+    if(ctx->current_weight > incumbent_weight(ctx))
+    {
+        update_record(ctx);
+    }
+}
+
+/*
+   Recolor the candidates of a node greedily, in the vertex sequence.
+   <return>
+    the sum of the largest weights of the color classes; the classes are
+    listed one after another in part->vertex, and class k ends before
+    class_end[k]
+ */
+static long long recolor_candidates(local_partition *part,long long *class_end,long long *number_of_classes)
+{
+    long long n=part->size;
+    long long length=(n+63)/64;
+    unsigned long long uncolored[REPARTITION_MAX/64];
+    long long colored=0;
+    long long bound=0;
+    *number_of_classes=0;
+    for(long long k=0;k<length;k++)
+    {
+        uncolored[k] = 64*(k+1) <= n ? ~0ULL : (1ULL<<(n-64*k))-1;
+    }
+    while(colored < n)
+    {
+        unsigned long long free_vertices[REPARTITION_MAX/64];
+        long long heaviest=0;
+        memcpy(free_vertices,uncolored,sizeof(unsigned long long)*length);
+        for(long long k=0;k<length;k++)
+        {
+            while(free_vertices[k] != 0)
+            {
+                long long u=64*k+__builtin_ctzll(free_vertices[k]);
+                for(long long l=k;l<length;l++)
+                {
+                    free_vertices[l] &= ~part->neighbours[u][l];
+                }
+                free_vertices[k] &= free_vertices[k]-1;
+                uncolored[k] &= ~(1ULL<<(u&63));
+                part->local[u]=colored;
+                part->position[colored]=u;
+                part->vertex[colored++]=part->sequence[u];
+                if(weight[part->sequence[u]] > heaviest)
+                {
+                    heaviest=weight[part->sequence[u]];
+                }
+            }
+        }
+        class_end[(*number_of_classes)++]=colored;
+        bound+=heaviest;
+    }
+    return bound;
+}
+
+/*
+   Search a node with fresh tables if its static tables overestimate.
+   The candidates are recolored, which takes O(n^2/64) word operations
+   on n candidates, and the node is pruned if the coloring bound is at
+   most the record.  Subsets are filled with whole color classes, and
+   their tables are built only if the coloring bound is below the bound
+   of the static tables, since the fresh tables bound no higher than the
+   coloring; the subtree is searched with them if they bound lower still.
+   The cost model in front skips nodes whose tables, of up to
+   2^REPARTITION_TABLE_BITS/REPARTITION_TABLE_BITS entries a candidate,
+   would cost more than the recent subtrees were worth.
+   <return>
+    1 if the node was pruned or searched, 0 if it is left to expand()
+ */
+static long long repartition_node(search_context *ctx,long long *set,long long set_size,long long upper)
+{
+    local_partition *part=ctx->partition;
+    double worth=ctx->repartition_mean_calls*REPARTITION_ENTRIES_PER_CALL*REPARTITION_TABLE_BITS;
+    long long sampled = ctx->repartition_mean_calls < 0 || ++ctx->repartition_visits % REPARTITION_SAMPLE_PERIOD == 0;
+    if(!sampled && worth < REPARTITION_MIN<<REPARTITION_TABLE_BITS)
+    {
+        return 0;
+    }
+    unsigned long long *live=live_words(set);
+    long long words[REPARTITION_MAX];
+    long long number_of_words=0;
+    long long n=0;
+    for(long long j=0;j<set_size;j++)
+    {
+        if((use_summaries && !((live[j>>6]>>(j&63))&1)) || set[j] == 0)
+        {
+            continue;
+        }
+        n+=__builtin_popcountll(set[j]);
+        if(n > REPARTITION_MAX)
+        {
+            return 0;
+        }
+        words[number_of_words++]=j;
+    }
+    if(n < REPARTITION_MIN)
+    {
+        return 0;
+    }
+    if(!sampled && worth < n<<REPARTITION_TABLE_BITS)
+    {
+        return 0;
+    }
+    ++ctx->repartition_tries;
+    double start=wall_clock();
+
+    /* the adjacency of the candidates, by position in the vertex sequence */
+    long long length=(n+63)/64;
+    part->size=n;
+    for(long long k=0,u=0;k<number_of_words;k++)
+    {
+        for(long long m=set[words[k]];m != 0;m &= m-1)
+        {
+            long long v=words[k]*limit+__builtin_ctzll(m);
+            part->sequence[u]=v;
+            part->position_of[v]=u;
+            memset(part->neighbours[u],0,sizeof(unsigned long long)*length);
+            u++;
+        }
+    }
+    for(long long u=0;u<n;u++)
+    {
+        long long v=part->sequence[u];
+        long long *adjv=ctx->adjacency_matrix[v];
+        for(long long k=0;k<number_of_words && words[k] < word_count[v];k++)
+        {
+            for(long long m=adjv[words[k]] & set[words[k]];m != 0;m &= m-1)
+            {
+                long long w=part->position_of[words[k]*limit+__builtin_ctzll(m)];
+                part->neighbours[u][w>>6] |= 1ULL<<(w&63);
+                part->neighbours[w][u>>6] |= 1ULL<<(u&63);
+            }
+        }
+    }
+
+    long long class_end[REPARTITION_MAX];
+    long long number_of_classes;
+    long long coloring_bound=recolor_candidates(part,class_end,&number_of_classes);
+    if(ctx->current_weight + coloring_bound <= gap_record(ctx))
+    {
+        ++ctx->repartition_prunes;
+        ctx->repartition_sec+=wall_clock()-start;
+        return 1;
+    }
+    if(coloring_bound >= upper)
+    {
+        ctx->repartition_sec+=wall_clock()-start;
+        return 0;
+    }
+
+    /* fill the subsets with whole color classes while they fit */
+    long long subset_of[REPARTITION_MAX];
+    long long number_of_subsets2=0;
+    long long filled=0;
+    for(long long k=0,u=0;k<number_of_classes;k++)
+    {
+        if(filled > 0 && filled+class_end[k]-u > REPARTITION_TABLE_BITS)
+        {
+            filled=0;
+        }
+        for(;u<class_end[k];u++)
+        {
+            if(filled == 0)
+            {
+                part->first[number_of_subsets2++]=u;
+            }
+            subset_of[u]=number_of_subsets2-1;
+            filled = filled+1 == REPARTITION_TABLE_BITS ? 0 : filled+1;
+        }
+    }
+    part->number_of_subsets=number_of_subsets2;
+    part->first[number_of_subsets2]=n;
+
+    /* the local adjacency rows and the fresh tables */
+    memset(part->adjacency,0,sizeof(long long)*n*number_of_subsets2);
+    for(long long u=0;u<n;u++)
+    {
+        long long *row=part->adjacency+part->local[u]*number_of_subsets2;
+        part->weight[part->local[u]]=weight[part->sequence[u]];
+        for(long long k=0;k<length;k++)
+        {
+            for(unsigned long long m=part->neighbours[u][k];m != 0;m &= m-1)
+            {
+                long long w=part->local[64*k+__builtin_ctzll(m)];
+                row[subset_of[w]] |= 1LL<<(w-part->first[subset_of[w]]);
+            }
+        }
+    }
+    long long *table=part->tables;
+    long long *set2=part->arena;
+    long long fresh_bound=0;
+    for(long long k=0;k<number_of_subsets2;k++)
+    {
+        long long size=part->first[k+1]-part->first[k];
+        part->optimal_table[k]=table;
+        table[0]=0;
+        for(long long b=0;b<size;b++)
+        {
+            long long u=part->first[k]+b;
+            dp_sweep(table,1LL<<b,part->adjacency[u*number_of_subsets2+k] & ((1LL<<b)-1),part->weight[u]);
+        }
+        set2[k]=(1LL<<size)-1;
+        fresh_bound+=table[set2[k]];
+        table+=1LL<<size;
+    }
+    for(long long k=0;k<length;k++)
+    {
+        set2[number_of_subsets2+k] = 64*(k+1) <= n ? ~0LL : (1LL<<(n-64*k))-1;
+    }
+    ctx->repartition_sec+=wall_clock()-start;
+    if(fresh_bound >= upper)
+    {
+        return 0;
+    }
+    ++ctx->repartition_count;
+    unsigned long calls=ctx->repartition_calls;
+    if(ctx->current_weight + fresh_bound > gap_record(ctx))
+    {
+        expand_repartitioned(ctx,part,set2,number_of_subsets2,fresh_bound);
+    }
+    calls=ctx->repartition_calls-calls;
+    ctx->repartition_mean_calls = ctx->repartition_mean_calls < 0 ? calls
+        : ctx->repartition_mean_calls+(calls-ctx->repartition_mean_calls)/16;
+    return 1;
+}
+
+/*
+   A bound which sees the conflicts between the subsets, by propagation
+   in the manner of MaxSAT upper bounds.
+   The core of subset j is the set of candidates of word j contained in
+   every optimal clique of the word.  A clique of the candidate set which
+   contains the whole core lies in its neighbourhood, which may lower the
+   tables of the other words; a clique which misses a core vertex c gets
+   at most optimal_table[j][set[j] without c] from word j.  The larger of
+   the two cases bounds the set, and the least such bound over the words
+   is returned when it is below upper.
+   <args>
+    upper: the bound of the optimal tables on the set
+   <return>
+    an upper bound of the weight of a clique in the set
+ */
+static long long propagation_bound(search_context *ctx,long long *set,long long set_size,long long upper)
+{
+    long long **adjacency_matrix=ctx->adjacency_matrix;
+    long long **optimal_table=ctx->optimal_table;
+    unsigned long long *live=live_words(set);
+    long long *words=ctx->lookahead;
+    long long *table=ctx->lookahead+number_of_subsets;
+    long long record=gap_record(ctx);
+    long long best=upper;
+    for(long long k=0;k<set_size;k++)
+    {
+        long long valid = !use_summaries || ((live[k>>6]>>(k&63)) & 1);
+        words[k] = valid ? set[k] : 0;
+        table[k] = optimal_table[k][words[k]];
+    }
+    for(long long j=0;j<set_size;j++)
+    {
+        long long core=0;
+        long long second=0;
+        for(long long m=words[j];m != 0;m &= m-1)
+        {
+            long long without=optimal_table[j][words[j] & ~(m & -m)];
+            if(without < table[j])
+            {
+                core |= m & -m;
+                if(without > second)
+                {
+                    second=without;
+                }
+            }
+        }
+        if(core == 0 || upper-table[j]+second >= best)
+        {
+            continue;
+        }
+        /* the cliques containing the core */
+        long long full=upper;
+        for(long long k=0;k<set_size && full > upper-table[j]+second;k++)
+        {
+            long long neighbours=words[k];
+            if(k < j)
+            {
+                for(long long m=core;m != 0;m &= m-1)
+                {
+                    neighbours &= adjacency_matrix[j*limit+__builtin_ctzll(m)][k];
+                }
+            }
+            else if(k > j)
+            {
+                for(long long m=words[k];m != 0;m &= m-1)
+                {
+                    if((adjacency_matrix[k*limit+__builtin_ctzll(m)][j] & core) != core)
+                    {
+                        neighbours &= ~(m & -m);
+                    }
+                }
+            }
+            full+=optimal_table[k][neighbours]-table[k];
+        }
+        long long bound = full > upper-table[j]+second ? full : upper-table[j]+second;
+        if(bound < best)
+        {
+            best=bound;
+            if(ctx->current_weight + best <= record)
+            {
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+/*
+   Try propagation_bound() on a node at a depth up to ctx->lookahead_limit.
+   The limit follows the prune rate at the deepest depth tried.
+   <return>
+    0 if the node is pruned, otherwise 1
+ */
+static long long lookahead_may_beat_record(search_context *ctx,long long *set,long long set_size,long long upper)
+{
+    long long depth=ctx->current_size;
+    if(depth > ctx->lookahead_limit)
+    {
+        return 1;
+    }
+    long long bound=propagation_bound(ctx,set,set_size,upper);
+    long long pruned = ctx->current_weight + bound <= gap_record(ctx);
+    ++ctx->lookahead_tries;
+    ctx->lookahead_prunes+=pruned;
+    if(depth == ctx->lookahead_limit)
+    {
+        ctx->lookahead_window_prunes+=pruned;
+        if(++ctx->lookahead_window_tries == LOOKAHEAD_WINDOW)
+        {
+            double rate=(double)ctx->lookahead_window_prunes/LOOKAHEAD_WINDOW;
+            if(rate >= LOOKAHEAD_RAISE_RATE && ctx->lookahead_limit < lookahead_depth)
+            {
+                ctx->lookahead_limit++;
+            }
+            else if(rate < LOOKAHEAD_LOWER_RATE && ctx->lookahead_limit > 1)
+            {
+                ctx->lookahead_limit--;
+            }
+            ctx->lookahead_window_tries=0;
+            ctx->lookahead_window_prunes=0;
+        }
+    }
+    return !pruned;
+}
+
+/*
+   The bookkeeping done when the search enters a node.
+   <return>
+    1 if the node is to be branched on by the caller,
+    0 if the search timed out, the node was shared with other threads,
+    or it was pruned or searched by repartition_node()
+ */
+static long long enter_node(search_context *ctx,long long *set,long long set_size,long long upper)
+{
+    ++ctx->branch_count;
+    if (ctx->branch_count % 100000 == 0)
+        check_for_stop();
+    if (search_stopped())
+        return 0;
+    if(lookahead_depth > 0 && !lookahead_may_beat_record(ctx,set,set_size,upper))
+    {
+        return 0;
+    }
+    if(sharing && ctx->current_size < MAX_SHARED_FRAMES
+            && (ctx->current_size < split_depth
+                || atomic_load_explicit(&busy_threads,memory_order_relaxed) < number_of_threads))
+    {
+        expand_shared(ctx,set,set_size,upper);
+        return 0;
+    }
+    if(ctx->current_size <= repartition_depth && repartition_node(ctx,set,set_size,upper))
+    {
+        return 0;
+    }
+    return 1;
+}
+
+/*
+   a candidate set of at most SMALL_SET_MAX vertices in one word:
+   bit u stands for vertex[u], in the order of the vertex sequence
+ */
+typedef struct
+{
+    long long size;
+    long long vertex[SMALL_SET_MAX];
+    long long weight[SMALL_SET_MAX];
+    unsigned long long adjacency[SMALL_SET_MAX]; /* the neighbours of bit u, once known has it */
+    unsigned long long known;
+    long long *set; /* the candidate set the bits are taken from */
+    long long **adjacency_matrix;
+    unsigned char local[SMALL_SET_MAX][64]; /* the bit in the small set of each vertex of a word */
+    long long number_of_words;
+    long long subset[SMALL_SET_MAX]; /* the subset of each nonempty word */
+    unsigned long long word_bits[SMALL_SET_MAX]; /* the bits of each nonempty word */
+    long long word[SMALL_SET_MAX]; /* the word of bit u */
+    long long bit[SMALL_SET_MAX]; /* the bit of vertex[u] in its subset */
+    long long **optimal_table;
+} small_set;
+
+/*
+   the words of the subsets of the candidates of a small set
+   <return>
+    the bound of the optimal tables on them
+ */
+static long long small_set_words(const small_set *small,unsigned long long candidates,long long *words)
+{
+    long long bound=0;
+    for(long long k=0;k<small->number_of_words;k++)
+    {
+        words[k]=0;
+    }
+    for(unsigned long long m=candidates;m != 0;m &= m-1)
+    {
+        long long u=__builtin_ctzll(m);
+        words[small->word[u]] |= small->bit[u];
+    }
+    for(long long k=0;k<small->number_of_words;k++)
+    {
+        bound+=small->optimal_table[small->subset[k]][words[k]];
+    }
+    return bound;
+}
+
+/*
+   <return>
+    the neighbours of bit u of a small set among the bits of its own and
+    the earlier words, which hold the candidates left when u is branched on
+ */
+static unsigned long long small_set_row(small_set *small,long long u)
+{
+    if((small->known>>u) & 1)
+    {
+        return small->adjacency[u];
+    }
+    long long v=small->vertex[u];
+    long long *adjv=small->adjacency_matrix[v];
+    long long k=small->word[u];
+    unsigned long long row=0;
+    for(long long m=small->set[small->subset[k]] & word_neighbours[v];m != 0;m &= m-1)
+    {
+        row |= 1ULL<<small->local[k][__builtin_ctzll(m)];
+    }
+    while(--k >= 0)
+    {
+        for(long long m=small->set[small->subset[k]] & adjv[small->subset[k]];m != 0;m &= m-1)
+        {
+            row |= 1ULL<<small->local[k][__builtin_ctzll(m)];
+        }
+    }
+    small->adjacency[u]=row;
+    small->known |= 1ULL<<u;
+    return row;
+}
+
+/*
+   choose the candidate of the highest word of a small set to branch on,
+   by the same policy as branch_bit(); ties go to the later vertex
+ */
+static long long small_set_branch(small_set *small,unsigned long long candidates)
+{
+    long long last=63-__builtin_clzll(candidates);
+    if(branching == BRANCH_MSB)
+    {
+        return last;
+    }
+    long long k=small->word[last];
+    unsigned long long top=candidates & small->word_bits[k];
+    long long subset_word=0;
+    for(unsigned long long m=top;m != 0;m &= m-1)
+    {
+        subset_word |= small->bit[__builtin_ctzll(m)];
+    }
+    long long best=last;
+    long long best_score=LLONG_MIN;
+    for(unsigned long long m=top;m != 0;m &= m-1)
+    {
+        long long u=__builtin_ctzll(m);
+        long long score=0;
+        if(branching == BRANCH_MAX_WEIGHT)
+        {
+            score=small->weight[u];
+        }
+        else if(branching == BRANCH_MAX_REDUCTION)
+        {
+            score=-small->optimal_table[small->subset[k]][subset_word & ~small->bit[u]];
+        }
+        else
+        {
+            for(unsigned long long n=candidates & small_set_row(small,u);n != 0;n &= n-1)
+            {
+                score+=small->weight[__builtin_ctzll(n)];
+            }
+        }
+        if(score >= best_score)
+        {
+            best_score=score;
+            best=u;
+        }
+    }
+    return best;
+}
+
+/*
+   Branch-and-bound on a small set, bit-parallel, with the bounds and the
+   branching of expand(): the optimal tables, kept per word in words, and
+   c[] of the last candidate, so that it visits the nodes expand() would.
+   Each child counts as one recursive call.
+ */
+static void expand_small_set(search_context *ctx,small_set *small,unsigned long long candidates,
+        long long *words,long long upper)
+{
+    long long **optimal_table=small->optimal_table;
+    long long child_words[SMALL_SET_MAX];
+    while(candidates != 0)
+    {
+        long long record=incumbent_weight(ctx);
+        /* check upper bound of optimal tables */
+        if(ctx->current_weight + upper <= with_gap(record))
+        {
+            return;
+        }
+        /* check upper bound of c[]*/
+        if(ctx->current_weight + c_of(small->vertex[63-__builtin_clzll(candidates)]) <= record)
+        {
+            ++ctx->c_prunes;
+            return;
+        }
+        long long u=small_set_branch(small,candidates);
+        unsigned long long child=candidates & small_set_row(small,u);
+        /* delete u from the candidates */
+        long long k=small->word[u];
+        candidates &= ~(1ULL<<u);
+        upper-=optimal_table[small->subset[k]][words[k]];
+        words[k] &= ~small->bit[u];
+        upper+=optimal_table[small->subset[k]][words[k]];
+
+        ctx->current_weight+=small->weight[u];
+        long long child_upper=small_set_words(small,child,child_words);
+        if(ctx->current_weight + child_upper > gap_record(ctx))
+        {
+            ctx->current[ctx->current_size++]=small->vertex[u];
+            ++ctx->branch_count;
+            if (ctx->branch_count % 100000 == 0)
+                check_for_stop();
+            if (!search_stopped())
+            {
+                expand_small_set(ctx,small,child,child_words,child_upper);
+            }
+            --ctx->current_size;
+        }
+        ctx->current_weight-=small->weight[u];
+    }
+    if(ctx->current_weight > incumbent_weight(ctx))
+    {
+        update_record(ctx);
+    }
+}
+
+/*
+   nonzero if the subtree of the node just entered is out of reach of
+   the features of enter_node() and delete_branch(): dominance deletion,
+   propagation, repartitioning and the sharing with idle threads
+ */
+static inline __attribute__((always_inline))
+long long may_solve_small_set(search_context *ctx)
+{
+    long long depth=ctx->current_size;
+    return depth > dominance_depth && depth >= lookahead_depth && depth >= repartition_depth
+        && (!sharing || (depth+1 >= split_depth
+                && atomic_load_explicit(&busy_threads,memory_order_relaxed) == number_of_threads));
+}
+
+/*
+   Compact a candidate set of at most small_set_limit vertices into one
+   word with local adjacency masks, and search it with expand_small_set().
+   <return>
+    1 if the set was searched, 0 if it has more than small_set_limit vertices
+ */
+static long long solve_small_set(search_context *ctx,long long *set,long long set_size,
+        const long long fixed_limit,const long long summarised)
+{
+    unsigned long long *live=live_words(set);
+    long long count=0;
+    for(long long j=highest_live_word(set,live,set_size-1,summarised);j >= 0;j=highest_live_word(set,live,j-1,summarised))
+    {
+        count+=__builtin_popcountll(set[j]);
+        if(count > small_set_limit)
+        {
+            return 0;
+        }
+    }
+    small_set small;
+    long long number_of_words=0;
+    small.size=0;
+    small.known=0;
+    small.set=set;
+    small.adjacency_matrix=ctx->adjacency_matrix;
+    small.optimal_table=ctx->optimal_table;
+    for(long long j=0;j<set_size;j++)
+    {
+        if((summarised && !((live[j>>6]>>(j&63))&1)) || set[j] == 0)
+        {
+            continue;
+        }
+        small.subset[number_of_words]=j;
+        small.word_bits[number_of_words]=0;
+        for(long long m=set[j];m != 0;m &= m-1)
+        {
+            long long v=j*fixed_limit+__builtin_ctzll(m);
+            small.local[number_of_words][__builtin_ctzll(m)]=small.size;
+            small.word[small.size]=number_of_words;
+            small.word_bits[number_of_words] |= 1ULL<<small.size;
+            small.bit[small.size]=m & -m;
+            small.vertex[small.size]=v;
+            small.weight[small.size]=weight[v];
+            small.size++;
+        }
+        number_of_words++;
+    }
+    small.number_of_words=number_of_words;
+    unsigned long long candidates = small.size == 64 ? ~0ULL : (1ULL<<small.size)-1;
+    long long words[SMALL_SET_MAX];
+    long long upper=small_set_words(&small,candidates,words);
+    ++ctx->small_set_count;
+    expand_small_set(ctx,&small,candidates,words,upper);
+    return 1;
+}
+
+/*
+   the current clique of a cursor, for the calls that read it from ctx
+ */
+static inline __attribute__((always_inline))
+void store_current(search_context *ctx,const search_cursor *cursor)
+{
+    ctx->current_size=cursor->current_size;
+    ctx->current_weight=cursor->current_weight;
+}
+
+/*
+   set a cursor to a node entered with the current clique of ctx
+ */
+static inline __attribute__((always_inline))
+void start_cursor(search_context *ctx,search_cursor *cursor,long long *set,long long set_size,long long upper)
+{
+    cursor->set=set;
+    cursor->live=live_words(set);
+    cursor->i=set_size-1;
+    cursor->upper=upper;
+    cursor->depth=ctx->current_size;
+    cursor->current_size=ctx->current_size;
+    cursor->current_weight=ctx->current_weight;
+}
+
+/* next_branch() found no branch left in the node */
+#define NODE_EXHAUSTED (-1)
+/* next_branch() found the bounds cannot beat the record */
+#define NODE_PRUNED (-2)
+
+/*
+   Find the next branch of the node of a cursor, from word cursor->i down,
+   unless the bounds of the optimal tables or of c[] cut the node.
+   <args>
+    reordered: set to nonzero if the vertex is not the msb of its word,
+     so that its child needs complete_word()
+   <return>
+    the vertex to branch on, NODE_EXHAUSTED or NODE_PRUNED
+ */
+static inline __attribute__((always_inline))
+long long next_branch(search_context *ctx,search_cursor *cursor,long long *reordered,
+        const long long fixed_limit,const long long summarised)
+{
+    long long *set=cursor->set;
+    for(long long i=highest_live_word(set,cursor->live,cursor->i,summarised);i >= 0;
+            i=highest_live_word(set,cursor->live,i-1,summarised))
+    {
+        if(set[i] == 0)
+        {
+            continue;
+        }
+        cursor->i=i;
+        long long record=incumbent_weight(ctx);
+        /* check upper bound of optimal tables */
+        if(cursor->current_weight + cursor->upper <= with_gap(record))
+        {
+            return NODE_PRUNED;
+        }
+        long long msb=msb_of(set[i]);
+        /* check upper bound of c[]*/
+        if(cursor->current_weight + c_of(i*fixed_limit + msb) <= record)
+        {
+            ++ctx->c_prunes;
+            return NODE_PRUNED;
+        }
+        long long bit=branch_bit(ctx,set,i,msb,fixed_limit,summarised);
+        *reordered = bit != msb;
+        return i*fixed_limit + bit;
+    }
+    return NODE_EXHAUSTED;
+}
+
+/*
+   add vertex to the current clique of a cursor
+ */
+static inline __attribute__((always_inline))
+void add_branch(search_context *ctx,search_cursor *cursor,long long vertex)
+{
+    ctx->current[cursor->current_size++] = vertex;
+    cursor->current_weight += weight[vertex];
+}
+
+/*
+   Descend to set2, the child of the branch on vertex, if its bound can
+   beat the record and enter_node() lets the caller branch on it.  A
+   small child out of reach of the features of enter_node() may be
+   searched by solve_small_set() instead.
+   <return>
+    1 if the cursor is at the child, 0 if it stays at the node
+ */
+static inline __attribute__((always_inline))
+long long descend(search_context *ctx,search_cursor *cursor,long long vertex,
+        long long *set2,long long set2_size,long long new_upper,
+        const long long fixed_limit,const long long summarised)
+{
+    if(cursor->current_weight + new_upper <= gap_record(ctx))
+    {
+        return 0;
+    }
+    store_current(ctx,cursor);
+    if(!enter_node(ctx,set2,set2_size,new_upper))
+    {
+        return 0;
+    }
+    if(small_set_limit > 0 && may_solve_small_set(ctx)
+            && solve_small_set(ctx,set2,set2_size,fixed_limit,summarised))
+    {
+        return 0;
+    }
+    expand_frame *frame=&ctx->stack[cursor->depth++];
+    frame->set=cursor->set;
+    frame->i=cursor->i;
+    frame->upper=cursor->upper;
+    frame->vertex=vertex;
+    cursor->set=set2;
+    cursor->live=live_words(set2);
+    cursor->i=set2_size-1;
+    cursor->upper=new_upper;
+    return 1;
+}
+
+/*
+   delete vertex, the branch searched last, from the current clique and
+   from the candidates of the node of a cursor
+ */
+static inline __attribute__((always_inline))
+void delete_branch(search_context *ctx,search_cursor *cursor,long long vertex,
+        const long long fixed_limit,const long long summarised)
+{
+    long long **optimal_table=ctx->optimal_table;
+    long long *set=cursor->set;
+    long long i=cursor->i;
+    --cursor->current_size;
+    cursor->current_weight -= weight[vertex];
+    cursor->upper-=optimal_table[i][set[i]];
+    delete_candidate(set,cursor->live,i,vertex-i*fixed_limit,summarised);
+    cursor->upper+=optimal_table[i][set[i]];
+    if(cursor->current_size <= dominance_depth)
+    {
+        cursor->upper+=delete_dominated(ctx,set,i,vertex,summarised);
+    }
+}
+
+/*
+   Leave the node of a cursor once next_branch() found no branch: update
+   the record if no candidate was left, then return to the parent and
+   delete the vertex branched on.
+   <args>
+    found: what next_branch() returned
+    base: the depth of the node the search started at
+   <return>
+    0 if the cursor was at base, 1 if it is at the parent
+ */
+static inline __attribute__((always_inline))
+long long leave_node(search_context *ctx,search_cursor *cursor,long long found,long long base,
+        const long long fixed_limit,const long long summarised)
+{
+    if(found == NODE_EXHAUSTED && cursor->current_weight > incumbent_weight(ctx))
+    {
+        store_current(ctx,cursor);
+        update_record(ctx);
+    }
+    if(cursor->depth == base)
+    {
+        store_current(ctx,cursor);
+        return 0;
+    }
+    expand_frame *frame=&ctx->stack[--cursor->depth];
+    cursor->set=frame->set;
+    cursor->live=live_words(frame->set);
+    cursor->i=frame->i;
+    cursor->upper=frame->upper;
+    delete_branch(ctx,cursor,frame->vertex,fixed_limit,summarised);
+    return 1;
+}
+
+/*
+   Branching procedure.
+   The recursion is run on the explicit stack of ctx: while a branch is
+   searched, the node whose current clique has d vertices is kept in
+   ctx->stack[d], and each entry of the stack counts as one recursive call.
+   It is compiled once for every subset size limit in SPECIALISED_LIMITS,
+   so that the products with the limit become constant arithmetic,
+   both with and without the summaries of the candidate sets.
+   <args>
+    ctx: the search thread
+    set: a vertex subset
+    set_size: the size of "set"
+    upper: an upper bound of the graph induced by "set"
+    fixed_limit: the subset size limit
+    summarised: nonzero if the summaries of the candidate sets are used
+ */
+static inline __attribute__((always_inline))
+void expand_with_limit(search_context *ctx,long long *set,long long set_size,long long upper,
+        const long long fixed_limit,const long long summarised)
+{
+    if(!enter_node(ctx,set,set_size,upper))
+    {
+        return;
+    }
+
+    long long **optimal_table=ctx->optimal_table;
+    long long base=ctx->current_size;
+    search_cursor cursor;
+    start_cursor(ctx,&cursor,set,set_size,upper);
+    for(;;)
+    {
+        long long reordered;
+        long long vertex=next_branch(ctx,&cursor,&reordered,fixed_limit,summarised);
+        if(vertex < 0)
+        {
+            if(!leave_node(ctx,&cursor,vertex,base,fixed_limit,summarised))
+            {
+                return;
+            }
+            continue;
+        }
+        add_branch(ctx,&cursor,vertex);
+        /* make new set */
+        long long set2_size = word_count[vertex];
+        long long* set2 = arena_level(ctx,cursor.current_size);
+        long long *adjv = ctx->adjacency_matrix[vertex];
+        long long new_upper;
+        if(delta_bound && !reordered)
+        {
+            long long floor=gap_record(ctx)-cursor.current_weight;
+            new_upper=intersect_candidates_by_delta(cursor.set,adjv,set2_size,set2,optimal_table,
+                    cursor.i,cursor.upper,floor,summarised);
+            ctx->delta_abandons += new_upper <= floor;
+        }
+        else
+        {
+            new_upper=intersect_candidates(cursor.set,adjv,set2_size,set2,optimal_table,summarised);
+        }
+        if(reordered)
+        {
+            new_upper+=complete_word(cursor.set,cursor.i,vertex,set2,&set2_size,optimal_table,summarised);
+        }
+        if(!descend(ctx,&cursor,vertex,set2,set2_size,new_upper,fixed_limit,summarised))
+        {
+            delete_branch(ctx,&cursor,vertex,fixed_limit,summarised);
+        }
+    }
+}
+
+/*
+   The kernels are compiled once more for processors with lzcnt, which
+   msb_of() then uses in place of bsr.
+ */
+#if defined(__x86_64__)
+#define LZCNT_TARGET __attribute__((target("lzcnt")))
+#else
+#define LZCNT_TARGET
+#endif
+
+#define EXPAND_WITH_FIXED_LIMIT(L) \
+    static void expand_limit_##L(search_context *ctx,long long *set,long long set_size,long long upper) \
+    { \
+        expand_with_limit(ctx,set,set_size,upper,L,0); \
+    } \
+    static void expand_summarised_limit_##L(search_context *ctx,long long *set,long long set_size,long long upper) \
+    { \
+        expand_with_limit(ctx,set,set_size,upper,L,1); \
+    } \
+    LZCNT_TARGET static void expand_lzcnt_limit_##L(search_context *ctx,long long *set,long long set_size,long long upper) \
+    { \
+        expand_with_limit(ctx,set,set_size,upper,L,0); \
+    } \
+    LZCNT_TARGET static void expand_summarised_lzcnt_limit_##L(search_context *ctx,long long *set,long long set_size,long long upper) \
+    { \
+        expand_with_limit(ctx,set,set_size,upper,L,1); \
+    }
+SPECIALISED_LIMITS(EXPAND_WITH_FIXED_LIMIT)
+
+static void expand_any_limit(search_context *ctx,long long *set,long long set_size,long long upper)
+{
+    expand_with_limit(ctx,set,set_size,upper,limit,0);
+}
+
+static void expand_summarised_any_limit(search_context *ctx,long long *set,long long set_size,long long upper)
+{
+    expand_with_limit(ctx,set,set_size,upper,limit,1);
+}
+
+LZCNT_TARGET static void expand_lzcnt_any_limit(search_context *ctx,long long *set,long long set_size,long long upper)
+{
+    expand_with_limit(ctx,set,set_size,upper,limit,0);
+}
+
+LZCNT_TARGET static void expand_summarised_lzcnt_any_limit(search_context *ctx,long long *set,long long set_size,long long upper)
+{
+    expand_with_limit(ctx,set,set_size,upper,limit,1);
+}
+
+typedef void (*expand_procedure)(search_context *ctx,long long *set,long long set_size,long long upper);
+
+#define EXPAND_KERNEL_ENTRY(L) [L] = expand_limit_##L,
+static const expand_procedure expand_kernels[] =
+{
+    SPECIALISED_LIMITS(EXPAND_KERNEL_ENTRY)
+};
+
+#define EXPAND_SUMMARISED_KERNEL_ENTRY(L) [L] = expand_summarised_limit_##L,
+static const expand_procedure expand_summarised_kernels[] =
+{
+    SPECIALISED_LIMITS(EXPAND_SUMMARISED_KERNEL_ENTRY)
+};
+
+#define EXPAND_LZCNT_KERNEL_ENTRY(L) [L] = expand_lzcnt_limit_##L,
+static const expand_procedure expand_lzcnt_kernels[] =
+{
+    SPECIALISED_LIMITS(EXPAND_LZCNT_KERNEL_ENTRY)
+};
+
+#define EXPAND_SUMMARISED_LZCNT_KERNEL_ENTRY(L) [L] = expand_summarised_lzcnt_limit_##L,
+static const expand_procedure expand_summarised_lzcnt_kernels[] =
+{
+    SPECIALISED_LIMITS(EXPAND_SUMMARISED_LZCNT_KERNEL_ENTRY)
+};
+
+/*
+   The summaries pay off only when the candidate sets have many words
+   and most of them become empty, that is, on sparse graphs.
+   On dense graphs almost every word stays nonzero and the bookkeeping
+   of the summaries slows the search down.
+ */
+static long long summaries_pay_off()
+{
+    long long n=input_graph->n;
+    long long edges=0;
+    if(number_of_subsets < SUMMARY_MIN_SUBSETS)
+    {
+        return 0;
+    }
+    for(long long i=0;i<n;i++)
+    {
+        edges+=count_nonzero(input_graph->adjacency_matrix[i],n);
+    }
+    return edges < SUMMARY_MAX_DENSITY*n*(n-1);
+}
+
+/*
+   choose the branching procedure compiled for the subset size limit
+ */
+static void select_expand_kernel()
+{
+    long long kernels=sizeof(expand_kernels)/sizeof(expand_kernels[0]);
+    const expand_procedure *fixed;
+    use_summaries=summaries_pay_off();
+    if(cpu_has_lzcnt())
+    {
+        expand_kernel=use_summaries ? expand_summarised_lzcnt_any_limit : expand_lzcnt_any_limit;
+        fixed=use_summaries ? expand_summarised_lzcnt_kernels : expand_lzcnt_kernels;
+    }
+    else
+    {
+        expand_kernel=use_summaries ? expand_summarised_any_limit : expand_any_limit;
+        fixed=use_summaries ? expand_summarised_kernels : expand_kernels;
+    }
+    if(limit < kernels && fixed[limit] != NULL)
+    {
+        expand_kernel=fixed[limit];
+    }
+}
+
+/*
+   choose the variants of the kernels for the processor; the
+   intersection kernel is chosen again by choose_intersection_kernel()
+ */
+static void select_kernels()
+{
+    select_cpu_kernels();
+    intersect_and_bound=select_intersect_and_bound(prefetch_distance);
+}
+
+/*
+   <return>
+    the time kernel takes to intersect the set of all vertices with the
+    adjacency rows long enough for it, in a scattered order, until
+    INTERSECTION_TIMING_LOOKUPS table lookups are done; 0 if no row is
+ */
+static double time_intersection_kernel(intersect_and_bound_kernel kernel)
+{
+    long long n_r=number_of_subsets*limit;
+    long long **tables=replica[0].optimal_table;
+    long long **adjacency=replica[0].adjacency_matrix;
+    long long *all=(long long *)malloc(sizeof(long long)*number_of_subsets);
+    long long *set2=(long long *)malloc(sizeof(long long)*number_of_subsets);
+    for(long long i=0;i<number_of_subsets;i++)
+    {
+        all[i]=(1<<subset_size[i])-1;
+    }
+    long long lookups=0;
+    long long sum=0;
+    double start=wall_clock();
+    while(lookups < INTERSECTION_TIMING_LOOKUPS)
+    {
+        long long rows=0;
+        for(long long k=0;k<n_r;k++)
+        {
+            long long v=(k*7919)%n_r;
+            long long size = v == 0 ? 0 : (v-1)/limit+1;
+            if(size >= SIMD_MIN_WORDS)
+            {
+                sum+=kernel(all,adjacency[v],size,set2,tables[0],table_offset);
+                lookups+=size;
+                rows++;
+            }
+        }
+        if(rows == 0)
+        {
+            break;
+        }
+    }
+    double sec = lookups > 0 ? wall_clock()-start : 0;
+    free(all);
+    free(set2);
+    /* the sum is used, so that the calls are not optimised away */
+    return sum < 0 ? 0 : sec;
+}
+
+/*
+   Choose the intersection kernel that is fastest on the tables of this
+   graph: which vector width pays off depends on the machine and on the
+   number of words of the candidate sets.  Then print the kernels.
+ */
+static void choose_intersection_kernel()
+{
+    intersect_and_bound=select_fastest_intersect_and_bound(time_intersection_kernel,
+            INTERSECTION_TIMING_ROUNDS);
+    printf("Kernels = msb %s, DP sweep %s, intersection %s, degree count %s\n",
+            cpu_has_lzcnt() ? "lzcnt" : "clz", dp_sweep_isa(),
+            intersect_and_bound_isa(), count_nonzero_isa());
+}
+
+/*
+   Report the rate of optimal table lookups of the scalar dense kernel,
+   without prefetching and with prefetching.
+   In every round each vertex intersects the set of all vertices with its
+   adjacency row; the vertices are visited in a scattered order.
+ */
+static void benchmark_table_lookups()
+{
+    long long n_r=number_of_subsets*limit;
+    long long **tables=replica[0].optimal_table;
+    long long **adjacency=replica[0].adjacency_matrix;
+    long long *all=(long long *)malloc(sizeof(long long)*number_of_subsets);
+    long long *set2=(long long *)malloc(sizeof(long long)*number_of_subsets);
+    long long distance = prefetch_distance > 0 ? prefetch_distance : BENCHMARK_PREFETCH_DISTANCE;
+    for(long long i=0;i<number_of_subsets;i++)
+    {
+        all[i]=(1<<subset_size[i])-1;
+    }
+    for(long long pass=0;pass<2;pass++)
+    {
+        long long ahead = pass == 0 ? 0 : distance;
+        long long lookups=0;
+        long long sum=0;
+        double start=wall_clock();
+        for(long long r=0;r<lookup_benchmark_rounds;r++)
+        {
+            for(long long k=0;k<n_r;k++)
+            {
+                long long v=(k*7919)%n_r;
+                long long size = v == 0 ? 0 : (v-1)/limit+1;
+                sum+=intersect_and_bound_ahead(all,adjacency[v],size,set2,tables[0],table_offset,ahead);
+                lookups+=size;
+            }
+        }
+        double sec=wall_clock()-start;
+        if(pass == 0)
+        {
+            printf("Table lookups/sec without prefetch = %.3e (checksum %lld)\n",
+                    lookups/sec, sum);
+        }
+        else
+        {
+            printf("Table lookups/sec with prefetch distance %lld = %.3e (checksum %lld)\n",
+                    distance, lookups/sec, sum);
+        }
+    }
+    free(all);
+    free(set2);
+}
+
+static void expand(search_context *ctx,long long *set,long long set_size,long long upper)
+{
+    expand_kernel(ctx,set,set_size,upper);
+}
+
+/*
+   Start a lane on the next branch of a frame whose bound can beat the record.
+   <return>
+    1 if the lane was started, 0 if the frame has no branch left
+ */
+static long long start_lane(search_lane *lane,shared_frame *frame)
+{
+    search_context *ctx=lane->ctx;
+    long long set2_size;
+    long long new_upper;
+    long long idle=0;
+    for(;;)
+    {
+        if(take_branch(ctx,frame,&set2_size,&new_upper,&idle) < 0)
+        {
+            return 0;
+        }
+        long long *set2=arena_level(ctx,ctx->current_size);
+        if(ctx->current_weight + new_upper > gap_record(ctx)
+                && enter_node(ctx,set2,set2_size,new_upper))
+        {
+            start_cursor(ctx,&lane->cursor,set2,set2_size,new_upper);
+            lane->base=ctx->current_size;
+            lane->set2=NULL;
+            return 1;
+        }
+    }
+}
+
+/*
+   One step of a lane: the same search as expand(), suspended after the
+   candidate set of each child has been intersected and prefetched.
+   <return>
+    1 if the lane was suspended, 0 if its branch is finished
+ */
+static long long step_lane(search_lane *lane)
+{
+    search_context *ctx=lane->ctx;
+    long long **optimal_table=ctx->optimal_table;
+    search_cursor cursor=lane->cursor;
+    if(lane->set2 != NULL)
+    {
+        /* the child intersected in the previous step */
+        long long new_upper=candidate_bound(lane->set2,lane->set2_size,optimal_table,use_summaries);
+        if(!descend(ctx,&cursor,lane->vertex,lane->set2,lane->set2_size,new_upper,limit,use_summaries))
+        {
+            delete_branch(ctx,&cursor,lane->vertex,limit,use_summaries);
+        }
+        lane->set2=NULL;
+    }
+    for(;;)
+    {
+        long long reordered;
+        long long vertex=next_branch(ctx,&cursor,&reordered,limit,use_summaries);
+        if(vertex < 0)
+        {
+            if(!leave_node(ctx,&cursor,vertex,lane->base,limit,use_summaries))
+            {
+                return 0;
+            }
+            continue;
+        }
+        add_branch(ctx,&cursor,vertex);
+        /* make new set, and leave its bound to the next step */
+        lane->set2=arena_level(ctx,cursor.current_size);
+        lane->set2_size=word_count[vertex];
+        intersect_and_prefetch(cursor.set,ctx->adjacency_matrix[vertex],lane->set2_size,lane->set2,
+                optimal_table,use_summaries);
+        if(reordered)
+        {
+            complete_word(cursor.set,cursor.i,vertex,lane->set2,&lane->set2_size,optimal_table,use_summaries);
+        }
+        lane->vertex=vertex;
+        lane->cursor=cursor;
+        return 1;
+    }
+}
+
+/*
+   Search the branches of a frame with interleaved_lanes lanes on this
+   thread, switching lanes at every table lookup, so that the lookups of
+   several independent subtrees are in flight together.
+ */
+static void search_interleaved(shared_frame *frame)
+{
+    long long running=0;
+    for(long long k=0;k<interleaved_lanes;k++)
+    {
+        lanes[k].active=start_lane(&lanes[k],frame);
+        running+=lanes[k].active;
+    }
+    while(running > 0)
+    {
+        for(long long k=0;k<interleaved_lanes;k++)
+        {
+            search_lane *lane=&lanes[k];
+            if(lane->active && !step_lane(lane))
             {
-                expand(set2,set2_size,new_upper);
+                lane->active=start_lane(lane,frame);
+                running-=!lane->active;
             }
-            free(set2);
-            --current_size;
-            current_weight -= weight[vertex];
-            /* delete vertex from set */
-            upper-=optimal_table[i][set[i]];
-            set[i] -= 1<<msb;
-            upper+=optimal_table[i][set[i]];
         }
     }
-    if(current_weight > record_weight) 
+}
+
+/*
+   Branching procedure for a node shared with the other threads.
+   The node is pushed to the deque of ctx, and its branches are taken
+   by ctx and by idle threads alike.
+ */
+static void expand_shared(search_context *ctx,long long *set,long long set_size,long long upper)
+{
+    long long top=atomic_load_explicit(&ctx->frames_top,memory_order_relaxed);
+    long long current_size=ctx->current_size;
+    long long current_weight=ctx->current_weight;
+    shared_frame *frame=&ctx->frames[top];
+
+    pthread_mutex_lock(&frame->lock);
+    memcpy(frame->set,set,sizeof(long long)*set_size);
+    memcpy(live_words(frame->set),live_words(set),sizeof(unsigned long long)*summary_words);
+    frame->set_size=set_size;
+    frame->upper=upper;
+    frame->i=set_size-1;
+    memcpy(frame->current,ctx->current,sizeof(long long)*current_size);
+    frame->current_size=current_size;
+    frame->current_weight=current_weight;
+    frame->exhausted=0;
+    atomic_store_explicit(&frame->steal_depth,current_size,memory_order_relaxed);
+    pthread_mutex_unlock(&frame->lock);
+    atomic_store_explicit(&ctx->frames_top,top+1,memory_order_release);
+    announce_frame();
+
+    long long idle=0;
+    while(search_branch(ctx,frame,&idle));
+
+    atomic_store_explicit(&ctx->frames_top,top,memory_order_release);
+    memcpy(ctx->current,frame->current,sizeof(long long)*current_size);
+    ctx->current_size=current_size;
+    ctx->current_weight=current_weight;
+    if(ctx->current_weight > incumbent_weight(ctx))
     {
-        memcpy(record,current,sizeof(long long)*current_size);
-        record_size=current_size;
-        record_weight = current_weight;
+        update_record(ctx);
     }
 }
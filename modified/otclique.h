@@ -27,9 +27,83 @@
 #ifndef otclique_h
 #define otclique_h
 
+#include <stdatomic.h>
 #include "weighted_graph.h"
 #include "clique.h"
 
+/*
+   The vertex of the highest nonzero word of a candidate set to branch on.
+    BRANCH_MSB: the last vertex in the vertex sequence (the original order).
+    BRANCH_MAX_WEIGHT: the heaviest vertex.
+    BRANCH_MAX_DEGREE: the vertex with the heaviest neighbourhood in the candidate set.
+    BRANCH_MAX_REDUCTION: the vertex whose deletion lowers the optimal table of the word most.
+ */
+typedef enum
+{
+    BRANCH_MSB,
+    BRANCH_MAX_WEIGHT,
+    BRANCH_MAX_DEGREE,
+    BRANCH_MAX_REDUCTION
+} branching_policy;
+
+/*
+   The greedy coloring that makes the vertex sequence and partition.
+    ORDER_BY_GRAPH: coloring_weighted on weighted graphs, otherwise coloring_unweighted.
+    ORDER_WEIGHTED: always coloring_weighted.
+    ORDER_UNWEIGHTED: always coloring_unweighted.
+ */
+typedef enum
+{
+    ORDER_BY_GRAPH,
+    ORDER_WEIGHTED,
+    ORDER_UNWEIGHTED
+} sequence_ordering;
+
+/* receives a clique (vertex numbers of the input graph) before its weight is published */
+typedef void (*record_listener)(const long long *vertices,long long size,long long weight);
+
+/* receives a root branch: its vertex, the candidates (vertex numbers of the
+   input graph) and the upper bound of the cliques of the branch */
+typedef void (*root_branch_visitor)(long long vertex,const long long *candidates,long long size,long long bound);
+
 clique * otclique(weighted_graph *graph,long long subset_size_limit);
 
+/*
+   Call visit with every root branch of the search of graph, from the
+   last vertex of the vertex sequence to the first: a vertex with its
+   neighbours earlier in the sequence as candidates, bounded by the
+   optimal tables.  Nothing is searched.
+ */
+void enumerate_root_branches(weighted_graph *graph,long long subset_size_limit,root_branch_visitor visit);
+void set_number_of_threads(long long threads);
+void set_number_of_processes(long long processes);
+void set_split_depth(long long depth);
+void set_interleaved_lanes(long long count);
+void set_small_set_limit(long long size);
+void set_delta_bound(long long delta);
+void set_prefetch_distance(long long distance);
+void set_lookup_benchmark(long long rounds);
+void set_branching_policy(branching_policy policy);
+void set_dominance_depth(long long depth);
+void set_lookahead_depth(long long depth);
+void set_repartition_depth(long long depth);
+void set_speculative_c(long long speculative);
+void set_deterministic(long long fixed_rounds);
+void set_c_stop_fraction(double fraction);
+void set_adaptive_c_stop(long long adaptive);
+void set_sequence_ordering(sequence_ordering order);
+void set_shared_record(_Atomic long long *record);
+void set_record_listener(record_listener record_found);
+void set_initial_record(long long weight);
+long long get_initial_record();
+void set_target_weight(long long weight);
+long long get_target_weight();
+void set_target_at_final(long long at_final);
+void set_gap(double ratio);
+unsigned long last_branch_count();
+long long parse_sequence_ordering(const char *name,sequence_ordering *order);
+const char *sequence_ordering_name(sequence_ordering order);
+long long parse_branching_policy(const char *name,branching_policy *policy);
+const char *branching_policy_name(branching_policy policy);
+
 #endif
@@ -14,22 +14,19 @@ else
     block_size_limit=20
 fi
 
-ifs_origin=$IFS 
-IFS=$'\n'
-result=(`./otclique $graph_file $block_size_limit`)
-IFS=$ifs_origin
+result=`./otclique $graph_file $block_size_limit`
 
 # Graph file name
 printf "%s," "${graph_file##*/}"
 # Subset size limit
-set -- ${result[0]}; printf "%s," $5
+printf "%s," `echo "$result" | grep '^Subset size limit' | cut -d ' ' -f5`
 # Precomputation phase time
-set -- ${result[2]}; printf "%s," $4
+printf "%s," `echo "$result" | grep '^Precomputation phase' | cut -d ' ' -f4`
 # Branch-and-bound time
-set -- ${result[3]}; printf "%s," $4
+printf "%s," `echo "$result" | grep '^Branch-and-bound phase' | cut -d ' ' -f4`
 # Branch-and-bound iterations
-set -- ${result[4]}; printf "%s," $4
+printf "%s," `echo "$result" | grep '^Branch-and-bound iterations' | cut -d ' ' -f4`
 # Total time
-set -- ${result[5]}; printf "%s," $4
+printf "%s," `echo "$result" | grep '^Total time' | cut -d ' ' -f4`
 # Maximum weight
-set -- ${result[6]}; printf "%s\n" $4
+printf "%s\n" `echo "$result" | grep '^Maximum weight' | cut -d ' ' -f4`
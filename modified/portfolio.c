@@ -0,0 +1,274 @@
+#define _GNU_SOURCE
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "portfolio.h"
+#include "otclique.h"
+#include "vertex_sequence_and_partition.h"
+#include "c_program_timing.h"
+#include "shared_record.h"
+
+typedef struct
+{
+    sequence_ordering ordering;
+    long long limit; /* 0 for the limit of the command line */
+    long long color_size_limit; /* 0 for the default of the coloring */
+    unsigned long long seed; /* 0 for no random tie-breaks */
+} portfolio_configuration;
+
+/*
+   the outcome of one configuration.
+    PORTFOLIO_RUNNING: not finished (stopped, if the portfolio is over).
+    PORTFOLIO_OPTIMAL: the search finished, so the record is optimal.
+    PORTFOLIO_TIMEOUT: the time limit expired.
+    PORTFOLIO_FAILED: the process died before it finished.
+ */
+typedef enum
+{
+    PORTFOLIO_RUNNING,
+    PORTFOLIO_OPTIMAL,
+    PORTFOLIO_TIMEOUT,
+    PORTFOLIO_FAILED
+} portfolio_status;
+
+typedef struct
+{
+    pid_t pid;
+    portfolio_status status;
+    long long found_weight; /* the heaviest clique this configuration found */
+    unsigned long iterations;
+    long msec;
+} portfolio_slot;
+
+static portfolio_configuration configurations[PORTFOLIO_MAX];
+static long long number_of_configurations=0;
+/* the record of all configurations; a clique is kept in it before its
+   weight is published, so the kept clique is never lighter than the record */
+static shared_record *record;
+static portfolio_slot *slots; /* shared by the processes */
+static long long own_slot; /* the configuration of this process */
+
+long long parse_portfolio(const char *spec)
+{
+    number_of_configurations=0;
+    const char *p=spec;
+    for(;;)
+    {
+        if(number_of_configurations == PORTFOLIO_MAX)
+        {
+            return 0;
+        }
+        portfolio_configuration *configuration=&configurations[number_of_configurations++];
+        memset(configuration,0,sizeof(*configuration));
+        size_t length=strcspn(p,":,");
+        char name[16];
+        if(length >= sizeof(name))
+        {
+            return 0;
+        }
+        memcpy(name,p,length);
+        name[length]='\0';
+        if(!parse_sequence_ordering(name,&configuration->ordering))
+        {
+            return 0;
+        }
+        p+=length;
+        long long *fields[]={&configuration->limit,&configuration->color_size_limit};
+        for(long long i=0;i<3 && *p == ':';i++)
+        {
+            char *end;
+            long long value=strtoll(p+1,&end,10);
+            if(end == p+1 || value < 0)
+            {
+                return 0;
+            }
+            if(i < 2)
+            {
+                *fields[i]=value;
+            }
+            else
+            {
+                configuration->seed=value;
+            }
+            p=end;
+        }
+        if(*p == '\0')
+        {
+            return 1;
+        }
+        if(*p != ',')
+        {
+            return 0;
+        }
+        ++p;
+    }
+}
+
+long long portfolio_size()
+{
+    return number_of_configurations;
+}
+
+/*
+   the record listener of a configuration
+ */
+static void publish_clique(const long long *vertices,long long size,long long weight)
+{
+    offer_shared_clique(record,vertices,size,weight);
+    if(weight > slots[own_slot].found_weight)
+    {
+        slots[own_slot].found_weight=weight;
+    }
+}
+
+/*
+   solve with configuration k in a child process, which never returns
+ */
+static void run_configuration(long long k,weighted_graph *graph,long long subset_size_limit)
+{
+    portfolio_configuration *configuration=&configurations[k];
+    own_slot=k;
+    set_sequence_ordering(configuration->ordering);
+    set_color_size_limit(configuration->color_size_limit);
+    set_tie_break_seed(configuration->seed);
+    set_shared_record(shared_record_weight(record));
+    set_record_listener(publish_clique);
+    if(freopen("/dev/null","w",stdout) == NULL)
+    {
+        _exit(1);
+    }
+    clique *result=otclique(graph,configuration->limit > 0 ? configuration->limit : subset_size_limit);
+    portfolio_slot *slot=&slots[k];
+    slot->iterations=last_branch_count();
+    slot->msec=get_elapsed_time_msec();
+    if(result->weight > slot->found_weight)
+    {
+        slot->found_weight=result->weight;
+    }
+    slot->status=is_timeout_flag_set() ? PORTFOLIO_TIMEOUT : PORTFOLIO_OPTIMAL;
+    _exit(0);
+}
+
+static void print_configuration(long long k,long long winner,long long subset_size_limit)
+{
+    portfolio_configuration *configuration=&configurations[k];
+    portfolio_slot *slot=&slots[k];
+    printf("Portfolio configuration %lld = %s, limit %lld, color size limit ",
+            k+1, sequence_ordering_name(configuration->ordering),
+            configuration->limit > 0 ? configuration->limit : subset_size_limit);
+    if(configuration->color_size_limit > 0)
+    {
+        printf("%lld",configuration->color_size_limit);
+    }
+    else
+    {
+        printf("default");
+    }
+    printf(", seed %llu: ",configuration->seed);
+    switch(slot->status)
+    {
+        case PORTFOLIO_OPTIMAL:
+            printf("%s in %.2f sec., %lu iterations",
+                    k == winner ? "proved optimality (winner)" : "proved optimality",
+                    slot->msec/1000.0, slot->iterations);
+            break;
+        case PORTFOLIO_TIMEOUT:
+            printf("timeout, %lu iterations", slot->iterations);
+            break;
+        case PORTFOLIO_FAILED:
+            printf("failed");
+            break;
+        default:
+            printf("stopped");
+            break;
+    }
+    printf(", found weight %lld\n", slot->found_weight);
+}
+
+clique *solve_portfolio(weighted_graph *graph,long long subset_size_limit)
+{
+    record=create_shared_record(graph->n);
+    atomic_store(shared_record_weight(record),get_initial_record());
+    size_t size=sizeof(portfolio_slot)*PORTFOLIO_MAX;
+    slots=(portfolio_slot *)map_shared_memory(size);
+
+    printf("Portfolio = %lld configurations\n", number_of_configurations);
+    fflush(stdout);
+    for(long long k=0;k<number_of_configurations;k++)
+    {
+        pid_t pid=fork();
+        if(pid == 0)
+        {
+            run_configuration(k,graph,subset_size_limit);
+        }
+        if(pid < 0)
+        {
+            perror("fork");
+            exit(1);
+        }
+        slots[k].pid=pid;
+    }
+
+    /* the first configuration to finish its search has proved optimality */
+    long long winner=-1;
+    long long running=number_of_configurations;
+    while(running > 0 && winner < 0)
+    {
+        int status;
+        pid_t pid=wait(&status);
+        if(pid < 0)
+        {
+            break;
+        }
+        running--;
+        for(long long k=0;k<number_of_configurations;k++)
+        {
+            if(slots[k].pid != pid)
+            {
+                continue;
+            }
+            if(slots[k].status == PORTFOLIO_OPTIMAL)
+            {
+                winner=k;
+            }
+            else if(slots[k].status == PORTFOLIO_RUNNING)
+            {
+                slots[k].status=PORTFOLIO_FAILED;
+            }
+        }
+    }
+    if(winner >= 0)
+    {
+        for(long long k=0;k<number_of_configurations;k++)
+        {
+            if(slots[k].status == PORTFOLIO_RUNNING)
+            {
+                kill(slots[k].pid,SIGKILL);
+            }
+        }
+        while(running-- > 0)
+        {
+            wait(NULL);
+        }
+    }
+    else
+    {
+        check_for_timeout();
+    }
+
+    for(long long k=0;k<number_of_configurations;k++)
+    {
+        print_configuration(k,winner,subset_size_limit);
+    }
+
+    clique *best=(clique *)malloc(sizeof(clique));
+    best->set=(long long *)malloc(sizeof(long long)*(graph->n > 0 ? graph->n : 1));
+    best->size=read_shared_clique(record,best->set,&best->weight);
+    destroy_shared_record(record);
+    unmap_shared_memory(slots,size);
+    return best;
+}
@@ -0,0 +1,35 @@
+#ifndef portfolio_h
+#define portfolio_h
+
+#include "weighted_graph.h"
+#include "clique.h"
+
+/* the most configurations a portfolio runs */
+#define PORTFOLIO_MAX 16
+
+/*
+   parse the configurations of a portfolio given on the command line:
+   a comma separated list of ordering[:limit[:color_size_limit[:seed]]]
+   <return>
+    1 if spec is well formed, otherwise 0
+ */
+long long parse_portfolio(const char *spec);
+
+/*
+   <return>
+    the number of configurations of the portfolio, 0 if none was given
+ */
+long long portfolio_size();
+
+/*
+   Run every configuration of the portfolio in its own process, all
+   sharing one record, until one of them proves optimality.
+   <args>
+    graph: the input graph
+    subset_size_limit: the limit of configurations that give none
+   <return>
+    the heaviest clique found by any configuration
+ */
+clique *solve_portfolio(weighted_graph *graph,long long subset_size_limit);
+
+#endif
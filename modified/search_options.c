@@ -0,0 +1,302 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "search_options.h"
+#include "numa_placement.h"
+#include "otclique.h"
+#include "portfolio.h"
+#include "vertex_sequence_and_partition.h"
+
+/*
+   Apply the "--name value" options of the command line
+   and remove them from argv.
+   <args>
+    argc, argv: the arguments given to main()
+   <return>
+    the number of remaining arguments, or -1 for a bad option
+ */
+int parse_search_options(int argc,char *argv[])
+{
+    int remaining=1;
+    for(int i=1;i<argc;i++)
+    {
+        if(strncmp(argv[i],"--",2) != 0)
+        {
+            argv[remaining++]=argv[i];
+            continue;
+        }
+        if(i+1 == argc)
+        {
+            fprintf(stderr,"Missing value for option %s\n",argv[i]);
+            return -1;
+        }
+        const char *name=argv[i]+2;
+        const char *value=argv[++i];
+        if(strcmp(name,"numa") == 0)
+        {
+            numa_placement_mode mode;
+            if(!parse_numa_placement(value,&mode))
+            {
+                fprintf(stderr,"Unknown NUMA placement \"%s\"\n",value);
+                return -1;
+            }
+            set_numa_placement(mode);
+        }
+        else if(strcmp(name,"threads") == 0)
+        {
+            long long threads=atoll(value);
+            if(threads < 1)
+            {
+                fprintf(stderr,"The number of threads must be positive\n");
+                return -1;
+            }
+            set_number_of_threads(threads);
+        }
+        else if(strcmp(name,"lower-bound") == 0)
+        {
+            long long lower_bound=atoll(value);
+            if(lower_bound < 0)
+            {
+                fprintf(stderr,"The lower bound must not be negative\n");
+                return -1;
+            }
+            set_initial_record(lower_bound);
+        }
+        else if(strcmp(name,"target") == 0)
+        {
+            long long target=atoll(value);
+            if(target < 1)
+            {
+                fprintf(stderr,"The target weight must be positive\n");
+                return -1;
+            }
+            set_target_weight(target);
+        }
+        else if(strcmp(name,"target-start") == 0)
+        {
+            if(strcmp(value,"first") == 0)
+            {
+                set_target_at_final(0);
+            }
+            else if(strcmp(value,"final") == 0)
+            {
+                set_target_at_final(1);
+            }
+            else
+            {
+                fprintf(stderr,"Unknown target start \"%s\"\n",value);
+                return -1;
+            }
+        }
+        else if(strcmp(name,"gap") == 0)
+        {
+            double ratio=atof(value);
+            if(ratio < 0)
+            {
+                fprintf(stderr,"The gap must not be negative\n");
+                return -1;
+            }
+            set_gap(ratio);
+        }
+        else if(strcmp(name,"processes") == 0)
+        {
+            long long processes=atoll(value);
+            if(processes < 1 || processes > 64)
+            {
+                fprintf(stderr,"The number of processes must be between 1 and 64\n");
+                return -1;
+            }
+            set_number_of_processes(processes);
+        }
+        else if(strcmp(name,"c-phase") == 0)
+        {
+            if(strcmp(value,"serial") == 0)
+            {
+                set_speculative_c(0);
+            }
+            else if(strcmp(value,"speculative") == 0)
+            {
+                set_speculative_c(1);
+            }
+            else
+            {
+                fprintf(stderr,"Unknown c[] phase \"%s\"\n",value);
+                return -1;
+            }
+        }
+        else if(strcmp(name,"c-stop") == 0)
+        {
+            if(strcmp(value,"auto") == 0)
+            {
+                set_adaptive_c_stop(1);
+                set_c_stop_fraction(0);
+            }
+            else
+            {
+                double fraction=atof(value);
+                if(fraction <= 0 || fraction > 1)
+                {
+                    fprintf(stderr,"The c[] stop fraction must be in (0,1] or auto\n");
+                    return -1;
+                }
+                set_adaptive_c_stop(0);
+                set_c_stop_fraction(fraction);
+            }
+        }
+        else if(strcmp(name,"schedule") == 0)
+        {
+            if(strcmp(value,"dynamic") == 0)
+            {
+                set_deterministic(0);
+            }
+            else if(strcmp(value,"deterministic") == 0)
+            {
+                set_deterministic(1);
+            }
+            else
+            {
+                fprintf(stderr,"Unknown schedule \"%s\"\n",value);
+                return -1;
+            }
+        }
+        else if(strcmp(name,"split-depth") == 0)
+        {
+            long long depth=atoll(value);
+            if(depth < 0)
+            {
+                fprintf(stderr,"The split depth must not be negative\n");
+                return -1;
+            }
+            set_split_depth(depth);
+        }
+        else if(strcmp(name,"interleave") == 0)
+        {
+            long long count=atoll(value);
+            if(count < 1)
+            {
+                fprintf(stderr,"The number of interleaved lanes must be positive\n");
+                return -1;
+            }
+            set_interleaved_lanes(count);
+        }
+        else if(strcmp(name,"child-bound") == 0)
+        {
+            if(strcmp(value,"scratch") == 0)
+            {
+                set_delta_bound(0);
+            }
+            else if(strcmp(value,"delta") == 0)
+            {
+                set_delta_bound(1);
+            }
+            else
+            {
+                fprintf(stderr,"Unknown child bound \"%s\"\n",value);
+                return -1;
+            }
+        }
+        else if(strcmp(name,"small-set") == 0)
+        {
+            long long size=atoll(value);
+            if(size < 0 || size > 64)
+            {
+                fprintf(stderr,"The small set size must be between 0 and 64\n");
+                return -1;
+            }
+            set_small_set_limit(size);
+        }
+        else if(strcmp(name,"branching") == 0)
+        {
+            branching_policy policy;
+            if(!parse_branching_policy(value,&policy))
+            {
+                fprintf(stderr,"Unknown branching policy \"%s\"\n",value);
+                return -1;
+            }
+            set_branching_policy(policy);
+        }
+        else if(strcmp(name,"ordering") == 0)
+        {
+            sequence_ordering order;
+            if(!parse_sequence_ordering(value,&order))
+            {
+                fprintf(stderr,"Unknown vertex sequence ordering \"%s\"\n",value);
+                return -1;
+            }
+            set_sequence_ordering(order);
+        }
+        else if(strcmp(name,"color-size-limit") == 0)
+        {
+            long long size=atoll(value);
+            if(size < 0)
+            {
+                fprintf(stderr,"The color size limit must not be negative\n");
+                return -1;
+            }
+            set_color_size_limit(size);
+        }
+        else if(strcmp(name,"tie-break-seed") == 0)
+        {
+            set_tie_break_seed(strtoull(value,NULL,10));
+        }
+        else if(strcmp(name,"portfolio") == 0)
+        {
+            if(!parse_portfolio(value))
+            {
+                fprintf(stderr,"Bad portfolio \"%s\"\n",value);
+                return -1;
+            }
+        }
+        else if(strcmp(name,"lookahead-depth") == 0)
+        {
+            long long depth=atoll(value);
+            if(depth < 0)
+            {
+                fprintf(stderr,"The lookahead depth must not be negative\n");
+                return -1;
+            }
+            set_lookahead_depth(depth);
+        }
+        else if(strcmp(name,"repartition-depth") == 0)
+        {
+            long long depth=atoll(value);
+            if(depth < 0)
+            {
+                fprintf(stderr,"The repartition depth must not be negative\n");
+                return -1;
+            }
+            set_repartition_depth(depth);
+        }
+        else if(strcmp(name,"dominance-depth") == 0)
+        {
+            long long depth=atoll(value);
+            if(depth < 0)
+            {
+                fprintf(stderr,"The dominance depth must not be negative\n");
+                return -1;
+            }
+            set_dominance_depth(depth);
+        }
+        else if(strcmp(name,"prefetch-distance") == 0)
+        {
+            long long distance=atoll(value);
+            if(distance < 0)
+            {
+                fprintf(stderr,"The prefetch distance must not be negative\n");
+                return -1;
+            }
+            set_prefetch_distance(distance);
+        }
+        else if(strcmp(name,"lookup-benchmark") == 0)
+        {
+            set_lookup_benchmark(atoll(value));
+        }
+        else
+        {
+            fprintf(stderr,"Unknown option %s\n",argv[i-1]);
+            return -1;
+        }
+    }
+    argv[remaining]=NULL;
+    return remaining;
+}
@@ -0,0 +1,6 @@
+#ifndef search_options_h
+#define search_options_h
+
+int parse_search_options(int argc,char *argv[]);
+
+#endif
@@ -0,0 +1,95 @@
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "shared_record.h"
+
+struct shared_record
+{
+    _Atomic long long weight; /* the published record weight */
+    pthread_mutex_t lock;
+    _Atomic long long active; /* the buffer holding the kept clique */
+    long long clique_weight[2];
+    long long clique_size[2];
+    long long capacity;
+    size_t mapped_size;
+    long long vertices[]; /* two buffers of capacity vertices */
+};
+
+void *map_shared_memory(size_t size)
+{
+    void *block=mmap(NULL,size,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_ANONYMOUS,-1,0);
+    if(block == MAP_FAILED)
+    {
+        fprintf(stderr,"Can't map %zu bytes of shared memory\n",size);
+        exit(1);
+    }
+    return block;
+}
+
+void unmap_shared_memory(void *block,size_t size)
+{
+    munmap(block,size);
+}
+
+shared_record *create_shared_record(long long capacity)
+{
+    size_t size=sizeof(shared_record)+sizeof(long long)*2*capacity;
+    shared_record *record=(shared_record *)map_shared_memory(size);
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setpshared(&attributes,PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attributes,PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&record->lock,&attributes);
+    pthread_mutexattr_destroy(&attributes);
+    atomic_store(&record->weight,0);
+    atomic_store(&record->active,0);
+    record->capacity=capacity;
+    record->mapped_size=size;
+    return record;
+}
+
+void destroy_shared_record(shared_record *record)
+{
+    pthread_mutex_destroy(&record->lock);
+    unmap_shared_memory(record,record->mapped_size);
+}
+
+_Atomic long long *shared_record_weight(shared_record *record)
+{
+    return &record->weight;
+}
+
+long long offer_shared_clique(shared_record *record,const long long *vertices,long long size,long long weight)
+{
+    if(pthread_mutex_lock(&record->lock) == EOWNERDEAD)
+    {
+        /* a process died while writing the buffer not in use */
+        pthread_mutex_consistent(&record->lock);
+    }
+    long long active=atomic_load(&record->active);
+    long long kept=weight > record->clique_weight[active];
+    if(kept)
+    {
+        long long next=1-active;
+        memcpy(record->vertices+next*record->capacity,vertices,sizeof(long long)*size);
+        record->clique_size[next]=size;
+        record->clique_weight[next]=weight;
+        atomic_store(&record->active,next);
+    }
+    pthread_mutex_unlock(&record->lock);
+    return kept;
+}
+
+long long read_shared_clique(shared_record *record,long long *vertices,long long *weight)
+{
+    long long active=atomic_load(&record->active);
+    long long size=record->clique_size[active];
+    memcpy(vertices,record->vertices+active*record->capacity,sizeof(long long)*size);
+    *weight=record->clique_weight[active];
+    return size;
+}
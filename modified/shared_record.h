@@ -0,0 +1,49 @@
+#ifndef shared_record_h
+#define shared_record_h
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/*
+   A record weight and the clique that holds it, in memory shared by the
+   processes forked after create_shared_record().
+   The clique is double buffered: a process writes the buffer not in use
+   and then flips to it, so a process killed while writing leaves the
+   other buffer whole.  Writers hold a robust process-shared mutex.
+ */
+typedef struct shared_record shared_record;
+
+/*
+   <args>
+    capacity: the most vertices of a clique
+ */
+shared_record *create_shared_record(long long capacity);
+void destroy_shared_record(shared_record *record);
+
+/*
+   the record weight, which is 0 until raised by a process
+ */
+_Atomic long long *shared_record_weight(shared_record *record);
+
+/*
+   keep a clique if it is heavier than the kept one
+   <return>
+    1 if the clique is kept, otherwise 0
+ */
+long long offer_shared_clique(shared_record *record,const long long *vertices,long long size,long long weight);
+
+/*
+   copy the kept clique to vertices (capacity entries),
+   once no process writes it any more
+   <return>
+    the size of the clique, whose weight is stored to *weight
+ */
+long long read_shared_clique(shared_record *record,long long *vertices,long long *weight);
+
+/*
+   map size bytes of zeroed memory shared with the processes forked later
+ */
+void *map_shared_memory(size_t size);
+void unmap_shared_memory(void *block,size_t size);
+
+#endif
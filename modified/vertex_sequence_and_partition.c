@@ -26,10 +26,62 @@
 
 #include "weighted_graph.h"
 #include "vertex_sequence_and_partition.h"
+#include "cpu_kernels.h"
 #include <stdlib.h>
 
 static long long* wt; /* vertex weight used in sorting*/
 static long long* dg; /* vertex degree used in sorting*/
+static unsigned long long* tie; /* random keys of vertices with equal sort keys, NULL if unused */
+static long long color_size_limit_override=0; /* 0 if the limit of the coloring follows the edge density */
+static unsigned long long tie_break_seed=0; /* 0 if equal sort keys are left to qsort() */
+
+/*
+   set the largest color class of the greedy coloring
+   (0 restores the default, which depends on the edge density)
+ */
+void set_color_size_limit(long long size)
+{
+    color_size_limit_override=size;
+}
+
+/*
+   break ties of the vertex sort at random with this seed
+   (0 leaves them to qsort(), the default)
+ */
+void set_tie_break_seed(unsigned long long seed)
+{
+    tie_break_seed=seed;
+}
+
+/*
+   draw the random keys of the n vertices (splitmix64)
+ */
+static unsigned long long *random_ties(long long n)
+{
+    if(tie_break_seed == 0)
+    {
+        return NULL;
+    }
+    unsigned long long *keys=(unsigned long long *)malloc(sizeof(unsigned long long)*n);
+    unsigned long long state=tie_break_seed;
+    for(long long i=0;i<n;i++)
+    {
+        unsigned long long z=(state+=0x9e3779b97f4a7c15ULL);
+        z=(z^(z>>30))*0xbf58476d1ce4e5b9ULL;
+        z=(z^(z>>27))*0x94d049bb133111ebULL;
+        keys[i]=z^(z>>31);
+    }
+    return keys;
+}
+
+static int compare_ties(long long v1,long long v2)
+{
+    if(tie == NULL || tie[v1] == tie[v2])
+    {
+        return 0;
+    }
+    return tie[v1] < tie[v2] ? -1 : 1;
+}
 
 /*
    comparing functions used in qsort()
@@ -40,6 +92,10 @@ static int comp_weight_nondecreasing( const void *c1, const void *c2 )
     long long v2=*(long long *)c2;
     if(wt[v1] == wt[v2])
     {
+        if(dg[v1] == dg[v2])
+        {
+            return compare_ties(v1,v2);
+        }
         return dg[v2]-dg[v1]; /* degree nonincreasing */
     }
     return wt[v1]-wt[v2]; /* weight nondecreasing */
@@ -49,6 +105,10 @@ static int comp_degree_nondecreasing( const void *c1, const void *c2 )
 {
     long long v1=*(long long *)c1;
     long long v2=*(long long *)c2;
+    if(dg[v1] == dg[v2])
+    {
+        return compare_ties(v1,v2);
+    }
     return dg[v1]-dg[v2]; /* degree nondecreasing */
 }
 
@@ -67,6 +127,7 @@ sequence_and_partition * coloring_weighted(weighted_graph *graph,long long limit
         else if(edge_density>=0.4) color_size_limit=8;
         else if(edge_density>=0.3) color_size_limit=12;
         else if(edge_density>=0.2) color_size_limit=20;
+        if(color_size_limit_override>0) color_size_limit=color_size_limit_override;
         if(color_size_limit>limit) color_size_limit=limit;
     }
 
@@ -75,14 +136,7 @@ sequence_and_partition * coloring_weighted(weighted_graph *graph,long long limit
     dg=(long long *)calloc(n,sizeof(long long));
     for(long long i=0; i < n;i++) //calculate degree
     {
-        long long *adjv=adjacency_matrix[i];
-        for(long long j=0; j < n;j++)
-        {
-            if(adjv[j])
-            {
-                dg[i]++;
-            }
-        }
+        dg[i]=count_nonzero(adjacency_matrix[i],n);
     }
 
     long long *order=(long long *)malloc(sizeof(long long)*n);
@@ -90,7 +144,9 @@ sequence_and_partition * coloring_weighted(weighted_graph *graph,long long limit
     {
         order[i] = i;
     }
+    tie=random_ties(n);
     qsort(order,n,sizeof(long long),comp_weight_nondecreasing);
+    free(tie);
 
     /* create uncolored set (bit set) */
     long long *uncolored=(long long *)malloc(sizeof(long long)*(n));
@@ -174,19 +230,13 @@ sequence_and_partition * coloring_unweighted(weighted_graph *graph,long long lim
     long long **adjacency_matrix=graph->adjacency_matrix;
 
     long long color_size_limit=limit;
+    if(color_size_limit_override>0 && color_size_limit_override<limit) color_size_limit=color_size_limit_override;
 
     /* sort vertices */
     dg=(long long *)calloc(n,sizeof(long long));
     for(long long i=0; i < n;i++) //calculate degree
     {
-        long long *adjv=adjacency_matrix[i];
-        for(long long j=0; j < n;j++)
-        {
-            if(adjv[j])
-            {
-                dg[i]++;
-            }
-        }
+        dg[i]=count_nonzero(adjacency_matrix[i],n);
     }
 
     long long *order=(long long *)malloc(sizeof(long long)*n);
@@ -194,7 +244,9 @@ sequence_and_partition * coloring_unweighted(weighted_graph *graph,long long lim
     {
         order[i] = i;
     }
+    tie=random_ties(n);
     qsort(order,n,sizeof(long long),comp_degree_nondecreasing);
+    free(tie);
 
     /* create uncolored set (bit set) */
     long long *uncolored=(long long *)malloc(sizeof(long long)*n);
@@ -38,5 +38,7 @@ typedef struct
 
 sequence_and_partition * coloring_weighted(weighted_graph *graph,long long limit);
 sequence_and_partition * coloring_unweighted(weighted_graph *graph,long long limit);
+void set_color_size_limit(long long size);
+void set_tie_break_seed(unsigned long long seed);
 
 #endif